@@ -0,0 +1,248 @@
+#include "Commandlets/GrappleVisibilityBakeCommandlet.h"
+
+#include "EngineUtils.h"
+#include "Async/ParallelFor.h"
+#include "Components/GrapplingHook/GrapplingComponent.h"
+#include "Components/GrapplingHook/GrappleVisibilitySubsystem.h"
+#include "Components/GrapplingHook/RopeComponent.h"
+#include "Engine/LevelStreaming.h"
+#include "Misc/FileHelper.h"
+
+UGrappleVisibilityBakeCommandlet::UGrappleVisibilityBakeCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UGrappleVisibilityBakeCommandlet::Main(const FString& Params)
+{
+	//parse the level to bake
+	FString MapPath;
+	if (!FParse::Value(*Params, TEXT("Map="), MapPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("GrappleVisibilityBake: missing -Map=<level package>"));
+		return 1;
+	}
+
+	//parse the bake settings (the defaults come from the grapple and rope components)
+	MaxDistance = GetDefault<UGrapplingComponent>()->MaxGrappleDistance;
+	CollisionChannel = GetDefault<URopeComponent>()->CollisionChannel;
+	FParse::Value(*Params, TEXT("CellSize="), CellSize);
+	FParse::Value(*Params, TEXT("MaxDistance="), MaxDistance);
+	FParse::Value(*Params, TEXT("RaysPerBinSide="), RaysPerBinSide);
+	CellSize = FMath::Max(CellSize, 100.f);
+	MaxDistance = FMath::Max(MaxDistance, 1.f);
+	RaysPerBinSide = FMath::Clamp(RaysPerBinSide, 1, 8);
+
+	//parse the output path
+	FString OutputPath = UGrappleVisibilitySubsystem::GetBakePath(MapPath);
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	//load the level
+	UWorld* World = LoadWorld(MapPath);
+	if (!World)
+	{
+		UE_LOG(LogTemp, Error, TEXT("GrappleVisibilityBake: failed to load %s"), *MapPath);
+		return 1;
+	}
+
+	//get the bounds of the static geometry
+	const FBox Bounds = GetStaticBounds(World);
+	if (!Bounds.IsValid)
+	{
+		UE_LOG(LogTemp, Error, TEXT("GrappleVisibilityBake: %s has no static geometry to bake"), *MapPath);
+		UnloadWorld(World);
+		return 1;
+	}
+
+	//setup the header
+	FGrappleVisibilityHeader Header;
+	Header.Magic = UGrappleVisibilitySubsystem::FileMagic;
+	Header.Version = UGrappleVisibilitySubsystem::FileVersion;
+	Header.Origin = FVector3f(Bounds.Min);
+	Header.CellSize = CellSize;
+	Header.Dimensions = FIntVector(FMath::Max(FMath::CeilToInt32(Bounds.GetSize().X / CellSize), 1), FMath::Max(FMath::CeilToInt32(Bounds.GetSize().Y / CellSize), 1), FMath::Max(FMath::CeilToInt32(Bounds.GetSize().Z / CellSize), 1));
+	Header.MaxDistance = MaxDistance;
+	Header.NumBins = UGrappleVisibilitySubsystem::NumBins;
+
+	//check if the grid is too big to bake (use a bigger cell size)
+	const int64 NumCells = int64(Header.Dimensions.X) * Header.Dimensions.Y * Header.Dimensions.Z;
+	if (NumCells > 4 * 1024 * 1024)
+	{
+		UE_LOG(LogTemp, Error, TEXT("GrappleVisibilityBake: %lld cells is too many, increase -CellSize"), NumCells);
+		UnloadWorld(World);
+		return 1;
+	}
+
+	//print the grid
+	UE_LOG(LogTemp, Display, TEXT("GrappleVisibilityBake: baking %s, %dx%dx%d cells of %.0f, %.0f max distance"), *MapPath, Header.Dimensions.X, Header.Dimensions.Y, Header.Dimensions.Z, CellSize, MaxDistance);
+
+	//only trace against static geometry (movable geometry isn't where it will be at runtime)
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(GrappleVisibilityBake), false);
+	QueryParams.MobilityType = EQueryMobilityType::Static;
+
+	//bake the cells in parallel (scene queries are safe to run from worker threads)
+	TArray<uint8> CellData;
+	CellData.SetNumZeroed(NumCells * UGrappleVisibilitySubsystem::NumBins);
+	const double StartTime = FPlatformTime::Seconds();
+	ParallelFor(static_cast<int32>(NumCells), [&](const int32 CellIndex)
+	{
+		//get the cell coordinates (x fastest then y then z)
+		const int32 X = CellIndex % Header.Dimensions.X;
+		const int32 Y = CellIndex / Header.Dimensions.X % Header.Dimensions.Y;
+		const int32 Z = CellIndex / (Header.Dimensions.X * Header.Dimensions.Y);
+
+		//bake the cell
+		BakeCell(World, Bounds.Min + FVector(X, Y, Z) * CellSize, QueryParams, CellData.GetData() + int64(CellIndex) * UGrappleVisibilitySubsystem::NumBins);
+	});
+
+	//print the bake time
+	UE_LOG(LogTemp, Display, TEXT("GrappleVisibilityBake: baked %lld cells in %.1f s"), NumCells, FPlatformTime::Seconds() - StartTime);
+
+	//unload the level
+	UnloadWorld(World);
+
+	//write the file
+	if (!WriteFile(OutputPath, Header, CellData))
+	{
+		UE_LOG(LogTemp, Error, TEXT("GrappleVisibilityBake: failed to write %s"), *OutputPath);
+		return 1;
+	}
+
+	//print the result
+	UE_LOG(LogTemp, Display, TEXT("GrappleVisibilityBake: wrote %lld bytes to %s"), int64(sizeof(FGrappleVisibilityHeader) + CellData.Num()), *OutputPath);
+
+	return 0;
+}
+
+UWorld* UGrappleVisibilityBakeCommandlet::LoadWorld(const FString& MapPath)
+{
+	//load the level package
+	UPackage* Package = LoadPackage(nullptr, *MapPath, LOAD_None);
+	UWorld* World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+	if (!World)
+	{
+		return nullptr;
+	}
+
+	//keep the world alive while we bake
+	World->AddToRoot();
+	World->WorldType = EWorldType::Editor;
+
+	//initialize the world with a physics scene so we can trace against it
+	if (!World->bIsWorldInitialized)
+	{
+		World->InitWorld(UWorld::InitializationValues()
+			.RequiresHitProxies(false)
+			.ShouldSimulatePhysics(false)
+			.EnableTraceCollision(true)
+			.CreateNavigation(false)
+			.CreateAISystem(false)
+			.AllowAudioPlayback(false)
+			.CreatePhysicsScene(true));
+	}
+
+	//add a world context for the world
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Editor);
+	WorldContext.SetCurrentWorld(World);
+
+	//register the components of the persistent level
+	World->UpdateWorldComponents(true, false);
+
+	//load all the streamed levels
+	for (ULevelStreaming* StreamingLevel : World->GetStreamingLevels())
+	{
+		StreamingLevel->SetShouldBeLoaded(true);
+		StreamingLevel->SetShouldBeVisible(true);
+	}
+	World->FlushLevelStreaming(EFlushLevelStreamingType::Full);
+
+	return World;
+}
+
+void UGrappleVisibilityBakeCommandlet::UnloadWorld(UWorld* World)
+{
+	//tear down the world
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	World->RemoveFromRoot();
+}
+
+FBox UGrappleVisibilityBakeCommandlet::GetStaticBounds(UWorld* World) const
+{
+	//storage for the bounds
+	FBox Bounds(ForceInit);
+
+	//iterate through all the actors
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		//add the bounds of every static primitive that blocks the collision channel
+		It->ForEachComponent<UPrimitiveComponent>(false, [&](const UPrimitiveComponent* Primitive)
+		{
+			if (Primitive->Mobility == EComponentMobility::Static && Primitive->IsQueryCollisionEnabled() && Primitive->GetCollisionResponseToChannel(CollisionChannel) == ECR_Block)
+			{
+				Bounds += Primitive->Bounds.GetBox();
+			}
+		});
+	}
+
+	return Bounds;
+}
+
+void UGrappleVisibilityBakeCommandlet::BakeCell(const UWorld* World, const FVector& CellMin, const FCollisionQueryParams& QueryParams, uint8* OutBins) const
+{
+	//get the center of the cell
+	const FVector Center = CellMin + FVector(CellSize * 0.5f);
+
+	//the points to trace from (the center and the corners of the cell, so surfaces hidden from the center by nearby geometry aren't missed)
+	FVector SamplePoints[9];
+	SamplePoints[0] = Center;
+	for (int32 Corner = 0; Corner < 8; ++Corner)
+	{
+		SamplePoints[Corner + 1] = CellMin + FVector(Corner & 1, (Corner >> 1) & 1, (Corner >> 2) & 1) * CellSize;
+	}
+
+	//iterate through the direction bins
+	for (int32 Bin = 0; Bin < UGrappleVisibilitySubsystem::NumBins; ++Bin)
+	{
+		//the farthest hit from the center of the cell
+		float FarthestHit = 0;
+
+		//trace a grid of rays through the bin from every sample point
+		for (const FVector& SamplePoint : SamplePoints)
+		{
+			for (int32 U = 0; U < RaysPerBinSide; ++U)
+			{
+				for (int32 V = 0; V < RaysPerBinSide; ++V)
+				{
+					//get the direction of the ray inside the bin
+					const FVector Direction = UGrappleVisibilitySubsystem::BinToDirection(Bin, (U + 0.5f) / RaysPerBinSide - 0.5f, (V + 0.5f) / RaysPerBinSide - 0.5f);
+
+					//trace the ray and check if it hit something
+					FHitResult Hit;
+					if (World->LineTraceSingleByChannel(Hit, SamplePoint, SamplePoint + Direction * MaxDistance, CollisionChannel, QueryParams))
+					{
+						//store the distance from the center of the cell (the runtime adds the distance from the center)
+						FarthestHit = FMath::Max(FarthestHit, FVector::Dist(Center, Hit.ImpactPoint));
+					}
+				}
+			}
+		}
+
+		//quantize the distance, rounding up so the stored distance is never too short (0 is reserved for nothing hit)
+		OutBins[Bin] = FarthestHit > 0 ? static_cast<uint8>(FMath::Clamp(FMath::CeilToInt32(FarthestHit / MaxDistance * 255), 1, 255)) : 0;
+	}
+}
+
+bool UGrappleVisibilityBakeCommandlet::WriteFile(const FString& FilePath, const FGrappleVisibilityHeader& Header, const TArray<uint8>& CellData)
+{
+	//copy the header and the cell data into one buffer
+	TArray<uint8> Bytes;
+	Bytes.SetNumUninitialized(sizeof(FGrappleVisibilityHeader) + CellData.Num());
+	FMemory::Memcpy(Bytes.GetData(), &Header, sizeof(FGrappleVisibilityHeader));
+	FMemory::Memcpy(Bytes.GetData() + sizeof(FGrappleVisibilityHeader), CellData.GetData(), CellData.Num());
+
+	return FFileHelper::SaveArrayToFile(Bytes, *FilePath);
+}
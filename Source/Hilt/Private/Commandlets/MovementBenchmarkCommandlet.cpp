@@ -0,0 +1,426 @@
+#include "Commandlets/MovementBenchmarkCommandlet.h"
+
+#include "EngineUtils.h"
+#include "InputActionValue.h"
+#include "Components/PlayerMovementComponent.h"
+#include "Components/GrapplingHook/GrapplingComponent.h"
+#include "Components/GrapplingHook/RopeComponent.h"
+#include "Core/HiltProfiling.h"
+#include "Engine/LevelStreaming.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerStart.h"
+#include "Misc/FileHelper.h"
+#include "Player/PlayerCharacter.h"
+#include "Player/ScoreComponent.h"
+
+namespace
+{
+	//the player class to spawn when none is given
+	const TCHAR* DefaultPlayerClassPath = TEXT("/Game/Blueprints/Player/BP_PlayerCharacter.BP_PlayerCharacter_C");
+
+	//the script to run when no input is given (run, jump, slide, dive, grapple swing while turning and fire)
+	const TCHAR* DefaultScript[] = {
+		TEXT("120 W"),
+		TEXT("20 W Jump"),
+		TEXT("100 W"),
+		TEXT("90 W Slide"),
+		TEXT("20 W Jump"),
+		TEXT("40 W Slide"),
+		TEXT("60 W"),
+		TEXT("30 Pitch=30"),
+		TEXT("180 W Grapple Yaw=45"),
+		TEXT("60 W D Yaw=-90"),
+		TEXT("1 Fire"),
+		TEXT("60 S A Pitch=-30"),
+	};
+
+	//the buttons that are pressed when they start being held in a script
+	constexpr uint8 ScriptPressedButtons = HiltInput_Grapple | HiltInput_Fire;
+}
+
+void FMovementBenchmarkTiming::Add(const double Seconds, const int32 NumSceneQueries)
+{
+	//add to the totals
+	TotalSeconds += Seconds;
+	MaxSeconds = FMath::Max(MaxSeconds, Seconds);
+	SceneQueries += NumSceneQueries;
+}
+
+UMovementBenchmarkCommandlet::UMovementBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UMovementBenchmarkCommandlet::Main(const FString& Params)
+{
+	//parse the map to load
+	FString MapPath;
+	if (!FParse::Value(*Params, TEXT("Map="), MapPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("MovementBenchmark: no map given, use -Map=/Game/TestMaps/<map>"));
+		return 1;
+	}
+
+	//parse the number of steps and the step rate
+	FParse::Value(*Params, TEXT("Frames="), NumFrames);
+	NumFrames = FMath::Max(NumFrames, 1);
+	FParse::Value(*Params, TEXT("StepRate="), StepRate);
+	StepRate = FMath::Max(StepRate, 1);
+
+	//parse the output path (the process id keeps parallel instances from writing to the same file)
+	FString OutputPath = FPaths::ProjectSavedDir() / FString::Printf(TEXT("Benchmarks/MovementBenchmark_%s_%u.csv"), *FPaths::GetBaseFilename(MapPath), FPlatformProcess::GetCurrentProcessId());
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	//parse the player class
+	FString PlayerClassPath = DefaultPlayerClassPath;
+	FParse::Value(*Params, TEXT("PlayerClass="), PlayerClassPath);
+	UClass* PlayerClass = LoadClass<APlayerCharacter>(nullptr, *PlayerClassPath);
+	if (!PlayerClass)
+	{
+		UE_LOG(LogTemp, Error, TEXT("MovementBenchmark: failed to load the player class %s"), *PlayerClassPath);
+		return 1;
+	}
+
+	//storage for the input (either recorded frames or script lines)
+	FString InputName = TEXT("DefaultScript");
+	FHiltRecordingHeader RecordingHeader;
+	TArray<FHiltInputFrame> RecordedFrames;
+	TArray<FMovementScriptLine> ScriptLines;
+
+	//check if we were given a recording
+	FString InputPath;
+	if (FParse::Value(*Params, TEXT("Input="), InputPath))
+	{
+		//load the recording
+		if (!UHiltSimulationSubsystem::LoadRecordingFile(InputPath, RecordingHeader, RecordedFrames) || RecordedFrames.IsEmpty())
+		{
+			UE_LOG(LogTemp, Error, TEXT("MovementBenchmark: failed to load the recording %s"), *InputPath);
+			return 1;
+		}
+
+		//check if the recording was made with a different step rate
+		if (RecordingHeader.StepRate != static_cast<uint32>(StepRate))
+		{
+			UE_LOG(LogTemp, Display, TEXT("MovementBenchmark: using the recording's step rate of %u"), RecordingHeader.StepRate);
+			StepRate = RecordingHeader.StepRate;
+		}
+
+		InputName = FPaths::GetCleanFilename(InputPath);
+	}
+	else
+	{
+		//get the script lines (from the script file or the default script)
+		TArray<FString> Lines(DefaultScript, UE_ARRAY_COUNT(DefaultScript));
+		if (FParse::Value(*Params, TEXT("Script="), InputPath))
+		{
+			//load the script file
+			if (!FFileHelper::LoadFileToStringArray(Lines, *InputPath))
+			{
+				UE_LOG(LogTemp, Error, TEXT("MovementBenchmark: failed to load the script %s"), *InputPath);
+				return 1;
+			}
+
+			InputName = FPaths::GetCleanFilename(InputPath);
+		}
+
+		//parse the script
+		if (!ParseScript(Lines, ScriptLines))
+		{
+			UE_LOG(LogTemp, Error, TEXT("MovementBenchmark: the script %s has no steps"), *InputName);
+			return 1;
+		}
+	}
+
+	//load the map
+	UWorld* World = LoadWorld(MapPath);
+	if (!World)
+	{
+		UE_LOG(LogTemp, Error, TEXT("MovementBenchmark: failed to load the map %s"), *MapPath);
+		return 1;
+	}
+
+	//get the step time
+	const float DeltaTime = 1.f / StepRate;
+
+	//get where to spawn the player (the recording's start, the first player start, or the world origin)
+	FTransform SpawnTransform = FTransform::Identity;
+	if (!RecordedFrames.IsEmpty())
+	{
+		SpawnTransform = FTransform(FRotator(RecordingHeader.StartRotation), FVector(RecordingHeader.StartLocation));
+	}
+	else if (TActorIterator<APlayerStart> PlayerStart(World); PlayerStart)
+	{
+		SpawnTransform = PlayerStart->GetActorTransform();
+	}
+
+	//spawn the player and a controller to possess it (no local player, so the player's input is driven from here)
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+	APlayerCharacter* Player = World->SpawnActor<APlayerCharacter>(PlayerClass, SpawnTransform, SpawnParams);
+	APlayerController* Controller = World->SpawnActor<APlayerController>();
+	if (!Player || !Controller)
+	{
+		UE_LOG(LogTemp, Error, TEXT("MovementBenchmark: failed to spawn the player in %s"), *MapPath);
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+		World->RemoveFromRoot();
+		return 1;
+	}
+	Controller->Possess(Player);
+	Controller->SetControlRotation(SpawnTransform.Rotator());
+
+	//tick the world once so everything has settled before we start timing
+	UHiltSimulationSubsystem::DisableComponentTicks(Player);
+	World->Tick(LEVELTICK_All, DeltaTime);
+
+	//the timings of the parts of the simulation
+	TArray<FMovementBenchmarkTiming> Timings;
+	for (const TCHAR* Name : { TEXT("World"), TEXT("Movement"), TEXT("Rope"), TEXT("Grapple"), TEXT("Score") })
+	{
+		Timings.Add({ Name });
+	}
+
+	//the state of the input
+	FRotator ControlRotation = SpawnTransform.Rotator();
+	int32 LineIndex = 0;
+	int32 LineStep = 0;
+	uint8 PreviousButtons = 0;
+
+	//get the start time of the run
+	const double RunStartTime = FPlatformTime::Seconds();
+
+	//simulate the run
+	for (int Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		//get the input frame of this step (the input loops if it's shorter than the run)
+		FHiltInputFrame InputFrame;
+		if (!RecordedFrames.IsEmpty())
+		{
+			InputFrame = RecordedFrames[Frame % RecordedFrames.Num()];
+		}
+		else
+		{
+			//make the input frame from the current script line
+			const FMovementScriptLine& Line = ScriptLines[LineIndex];
+			MakeScriptFrame(Player, Line, PreviousButtons, DeltaTime, ControlRotation, InputFrame);
+			PreviousButtons = Line.Buttons;
+
+			//check if we've held the line for long enough
+			if (++LineStep >= Line.NumSteps)
+			{
+				//move on to the next line
+				LineStep = 0;
+				LineIndex = (LineIndex + 1) % ScriptLines.Num();
+			}
+		}
+
+		//apply the input frame (also updates the camera so the grapple aims where the control rotation points)
+		UHiltSimulationSubsystem::ApplyInputFrame(Player, InputFrame, DeltaTime);
+
+		//time the world tick (everything except the player's stepped components, including the ground probe)
+		HiltProfiling::ResetCounters();
+		const double WorldStartTime = FPlatformTime::Seconds();
+		World->Tick(LEVELTICK_All, DeltaTime);
+		Timings[0].Add(FPlatformTime::Seconds() - WorldStartTime, HiltProfiling::SceneQueries);
+
+		//time the player's components in the order they'd tick in
+		TimeComponentTick(Player->PlayerMovementComponent, DeltaTime, Timings[1]);
+		TimeComponentTick(Player->RopeComponent, DeltaTime, Timings[2]);
+		TimeComponentTick(Player->GrappleComponent, DeltaTime, Timings[3]);
+		TimeComponentTick(Player->ScoreComponent, DeltaTime, Timings[4]);
+
+		//the rope enables its own tick when it's activated
+		UHiltSimulationSubsystem::DisableComponentTicks(Player);
+	}
+
+	//get the wall time of the run
+	const double WallSeconds = FPlatformTime::Seconds() - RunStartTime;
+
+	//print the results
+	for (const FMovementBenchmarkTiming& Timing : Timings)
+	{
+		UE_LOG(LogTemp, Display, TEXT("MovementBenchmark: %-8s %.4f ms/frame (max %.4f), %.2f queries/frame"), *Timing.Name, Timing.TotalSeconds * 1000 / NumFrames, Timing.MaxSeconds * 1000, double(Timing.SceneQueries) / NumFrames);
+	}
+	UE_LOG(LogTemp, Display, TEXT("MovementBenchmark: %s with %s, %d frames in %.2f s (%.0f frames/s), ended at %s"), *MapPath, *InputName, NumFrames, WallSeconds, NumFrames / FMath::Max(WallSeconds, UE_DOUBLE_SMALL_NUMBER), *Player->GetActorLocation().ToCompactString());
+
+	//tear down the world
+	Player->GrappleComponent->StopGrapple();
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	World->RemoveFromRoot();
+
+	//write the results
+	if (!WriteResults(OutputPath, MapPath, InputName, Timings, WallSeconds))
+	{
+		UE_LOG(LogTemp, Error, TEXT("MovementBenchmark: failed to write results to %s"), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("MovementBenchmark: wrote results to %s"), *OutputPath);
+	return 0;
+}
+
+UWorld* UMovementBenchmarkCommandlet::LoadWorld(const FString& MapPath)
+{
+	//load the level package
+	UPackage* Package = LoadPackage(nullptr, *MapPath, LOAD_None);
+	UWorld* World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+	if (!World)
+	{
+		return nullptr;
+	}
+
+	//keep the world alive while we run
+	World->AddToRoot();
+	World->WorldType = EWorldType::Game;
+
+	//initialize the world with a physics scene so the player can move through it
+	if (!World->bIsWorldInitialized)
+	{
+		World->InitWorld(UWorld::InitializationValues()
+			.RequiresHitProxies(false)
+			.ShouldSimulatePhysics(true)
+			.EnableTraceCollision(true)
+			.CreateNavigation(false)
+			.CreateAISystem(false)
+			.AllowAudioPlayback(false)
+			.CreatePhysicsScene(true));
+	}
+
+	//add a world context for the world
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	//register the components of the persistent level
+	World->UpdateWorldComponents(true, false);
+
+	//load all the streamed levels
+	for (ULevelStreaming* StreamingLevel : World->GetStreamingLevels())
+	{
+		StreamingLevel->SetShouldBeLoaded(true);
+		StreamingLevel->SetShouldBeVisible(true);
+	}
+	World->FlushLevelStreaming(EFlushLevelStreamingType::Full);
+
+	//start play
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+
+	return World;
+}
+
+bool UMovementBenchmarkCommandlet::ParseScript(const TArray<FString>& ScriptLines, TArray<FMovementScriptLine>& OutLines)
+{
+	//iterate through the lines
+	for (FString ScriptLine : ScriptLines)
+	{
+		//remove comments
+		int32 CommentIndex;
+		if (ScriptLine.FindChar(TEXT('#'), CommentIndex))
+		{
+			ScriptLine.LeftInline(CommentIndex);
+		}
+
+		//split the line into tokens
+		TArray<FString> Tokens;
+		ScriptLine.ParseIntoArrayWS(Tokens);
+
+		//check if the line is empty or doesn't start with a step count
+		if (Tokens.IsEmpty() || !Tokens[0].IsNumeric())
+		{
+			continue;
+		}
+
+		//set the step count
+		FMovementScriptLine Line;
+		Line.NumSteps = FMath::Max(FCString::Atoi(*Tokens[0]), 1);
+
+		//iterate through the keys of the line
+		for (int Index = 1; Index < Tokens.Num(); ++Index)
+		{
+			const FString& Token = Tokens[Index];
+
+			//check for the movement keys
+			if (Token == TEXT("W")) { Line.MoveDirection.Y += 1; }
+			else if (Token == TEXT("S")) { Line.MoveDirection.Y -= 1; }
+			else if (Token == TEXT("D")) { Line.MoveDirection.X += 1; }
+			else if (Token == TEXT("A")) { Line.MoveDirection.X -= 1; }
+
+			//check for the buttons (dive is slide in the air)
+			else if (Token == TEXT("Jump")) { Line.Buttons |= HiltInput_Jump; }
+			else if (Token == TEXT("Slide") || Token == TEXT("Dive")) { Line.Buttons |= HiltInput_Slide; }
+			else if (Token == TEXT("Grapple")) { Line.Buttons |= HiltInput_Grapple; }
+			else if (Token == TEXT("Fire")) { Line.Buttons |= HiltInput_Fire; }
+
+			//check for the turn rates
+			else if (Token.StartsWith(TEXT("Yaw="))) { Line.YawRate = FCString::Atof(*Token.RightChop(4)); }
+			else if (Token.StartsWith(TEXT("Pitch="))) { Line.PitchRate = FCString::Atof(*Token.RightChop(6)); }
+
+			else
+			{
+				UE_LOG(LogTemp, Warning, TEXT("MovementBenchmark: unknown script key %s"), *Token);
+			}
+		}
+
+		OutLines.Add(Line);
+	}
+
+	return !OutLines.IsEmpty();
+}
+
+void UMovementBenchmarkCommandlet::MakeScriptFrame(APlayerCharacter* Player, const FMovementScriptLine& Line, const uint8 PreviousButtons, const float DeltaTime, FRotator& InOutControlRotation, FHiltInputFrame& OutFrame)
+{
+	//turn the control rotation
+	InOutControlRotation.Yaw = FRotator::NormalizeAxis(InOutControlRotation.Yaw + Line.YawRate * DeltaTime);
+	InOutControlRotation.Pitch = FMath::Clamp(InOutControlRotation.Pitch + Line.PitchRate * DeltaTime, -89.f, 89.f);
+	Player->GetController()->SetControlRotation(InOutControlRotation);
+
+	//let the player turn the wasd direction into movement input the same way it does for a real key press
+	Player->ConsumeMovementInputVector();
+	Player->WasdMovement(FInputActionValue(Line.MoveDirection));
+
+	//set the movement input and rotation of the frame
+	OutFrame.MovementInput = FVector3f(Player->ConsumeMovementInputVector());
+	OutFrame.MoveDirection = FVector2f(Player->CurrentMoveDirection);
+	OutFrame.ControlRotation = FRotator3f(InOutControlRotation);
+
+	//set the held buttons, only pressing grapple and fire on the step they start being held
+	OutFrame.Buttons = Line.Buttons & ~(PreviousButtons & ScriptPressedButtons);
+
+	//check if grapple was let go of
+	if ((PreviousButtons & HiltInput_Grapple) && !(Line.Buttons & HiltInput_Grapple))
+	{
+		OutFrame.Buttons |= HiltInput_StopGrapple;
+	}
+}
+
+void UMovementBenchmarkCommandlet::TimeComponentTick(UActorComponent* Component, const float DeltaTime, FMovementBenchmarkTiming& Timing)
+{
+	//reset the counters
+	HiltProfiling::ResetCounters();
+
+	//time the component tick
+	const double StartTime = FPlatformTime::Seconds();
+	Component->TickComponent(DeltaTime, LEVELTICK_All, &Component->PrimaryComponentTick);
+	Timing.Add(FPlatformTime::Seconds() - StartTime, HiltProfiling::SceneQueries);
+}
+
+bool UMovementBenchmarkCommandlet::WriteResults(const FString& FilePath, const FString& MapPath, const FString& InputName, const TArray<FMovementBenchmarkTiming>& Timings, const double WallSeconds) const
+{
+	//add the header
+	FString Csv = TEXT("Map,Input,Part,Frames,StepRate,MsPerFrame,MaxMsPerFrame,SceneQueriesPerFrame\n");
+
+	//add a row per part of the simulation
+	for (const FMovementBenchmarkTiming& Timing : Timings)
+	{
+		Csv += FString::Printf(TEXT("%s,%s,%s,%d,%d,%.4f,%.4f,%.2f\n"), *MapPath, *InputName, *Timing.Name, NumFrames, StepRate, Timing.TotalSeconds * 1000 / NumFrames, Timing.MaxSeconds * 1000, double(Timing.SceneQueries) / NumFrames);
+	}
+
+	//add a row for the whole run
+	Csv += FString::Printf(TEXT("%s,%s,Total,%d,%d,%.4f,,\n"), *MapPath, *InputName, NumFrames, StepRate, WallSeconds * 1000 / NumFrames);
+
+	return FFileHelper::SaveStringToFile(Csv, *FilePath);
+}
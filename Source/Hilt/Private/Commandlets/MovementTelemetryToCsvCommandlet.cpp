@@ -0,0 +1,85 @@
+#include "Commandlets/MovementTelemetryToCsvCommandlet.h"
+
+#include "Core/MovementTelemetry.h"
+#include "Engine/EngineTypes.h"
+#include "Misc/FileHelper.h"
+
+UMovementTelemetryToCsvCommandlet::UMovementTelemetryToCsvCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UMovementTelemetryToCsvCommandlet::Main(const FString& Params)
+{
+	//parse the input path
+	FString InputPath;
+	if (!FParse::Value(*Params, TEXT("Input="), InputPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("MovementTelemetryToCsv: no input given, use -Input=<htel>"));
+		return 1;
+	}
+
+	//parse the output path (defaults to the input path with a csv extension)
+	FString OutputPath = FPaths::ChangeExtension(InputPath, TEXT("csv"));
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	//read the file
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *InputPath) || Bytes.Num() < static_cast<int32>(sizeof(FMovementTelemetryHeader)))
+	{
+		UE_LOG(LogTemp, Error, TEXT("MovementTelemetryToCsv: failed to read %s"), *InputPath);
+		return 1;
+	}
+
+	//read the header and check that it's a telemetry file we can read
+	FMovementTelemetryHeader Header;
+	FMemory::Memcpy(&Header, Bytes.GetData(), sizeof(Header));
+	if (Header.Magic != FMovementTelemetryHeader::FileMagic || Header.Version != FMovementTelemetryHeader::FileVersion || Header.RecordSize != sizeof(FMovementTelemetryRecord))
+	{
+		UE_LOG(LogTemp, Error, TEXT("MovementTelemetryToCsv: %s isn't a version %u telemetry file"), *InputPath, FMovementTelemetryHeader::FileVersion);
+		return 1;
+	}
+
+	//get the number of records (ignoring a partly written record at the end)
+	const int32 NumRecords = static_cast<int32>((Bytes.Num() - sizeof(FMovementTelemetryHeader)) / sizeof(FMovementTelemetryRecord));
+	const FMovementTelemetryRecord* Records = reinterpret_cast<const FMovementTelemetryRecord*>(Bytes.GetData() + sizeof(FMovementTelemetryHeader));
+
+	//get the movement mode enum for the mode names
+	const UEnum* MovementModeEnum = StaticEnum<EMovementMode>();
+
+	//add the header
+	FString Csv = TEXT("Frame,Time,X,Y,Z,VelocityX,VelocityY,VelocityZ,Speed,HorizontalSpeed,MovementMode,Sliding,Diving,SlideJumping,SlideFalling,Grappling,SpeedLimited,Score,ScoreTier\n");
+	Csv.Reserve(NumRecords * 160);
+
+	//add a row per record
+	for (int32 Index = 0; Index < NumRecords; ++Index)
+	{
+		//copy the record (the file data isn't guaranteed to be aligned)
+		FMovementTelemetryRecord Record;
+		FMemory::Memcpy(&Record, &Records[Index], sizeof(Record));
+
+		//get the flag helper
+		auto Flag = [&Record](const uint8 InFlag) { return (Record.Flags & InFlag) ? 1 : 0; };
+
+		Csv += FString::Printf(TEXT("%u,%.4f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%s,%d,%d,%d,%d,%d,%d,%.2f,%u\n"),
+			Record.Frame, Record.Time,
+			Record.Location.X, Record.Location.Y, Record.Location.Z,
+			Record.Velocity.X, Record.Velocity.Y, Record.Velocity.Z, Record.Velocity.Size(), Record.Velocity.Size2D(),
+			*MovementModeEnum->GetNameStringByValue(Record.MovementMode),
+			Flag(MovementTelemetry_Sliding), Flag(MovementTelemetry_Diving), Flag(MovementTelemetry_SlideJumping), Flag(MovementTelemetry_SlideFalling), Flag(MovementTelemetry_Grappling), Flag(MovementTelemetry_SpeedLimited),
+			Record.Score, static_cast<uint32>(Record.ScoreTier));
+	}
+
+	//write the csv
+	if (!FFileHelper::SaveStringToFile(Csv, *OutputPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("MovementTelemetryToCsv: failed to write %s"), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("MovementTelemetryToCsv: wrote %d records to %s"), NumRecords, *OutputPath);
+	return 0;
+}
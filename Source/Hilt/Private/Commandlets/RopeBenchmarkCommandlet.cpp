@@ -0,0 +1,402 @@
+#include "Commandlets/RopeBenchmarkCommandlet.h"
+
+#include "Components/GrapplingHook/RopeComponent.h"
+#include "Core/HiltProfiling.h"
+#include "Curves/CurveFloat.h"
+#include "Engine/StaticMeshActor.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "NPC/Components/GrappleableComponent.h"
+
+FString FRopeBenchmarkResult::GetKey() const
+{
+	return FString::Printf(TEXT("%s|%d|%d|%s"), *Scenario, NumVerletPoints, NumConstraintIterations, bUseVerletIntegration ? TEXT("Verlet") : TEXT("Pivot"));
+}
+
+URopeBenchmarkCommandlet::URopeBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 URopeBenchmarkCommandlet::Main(const FString& Params)
+{
+	//parse the number of ticks per run
+	FParse::Value(*Params, TEXT("Ticks="), NumTicks);
+	NumTicks = FMath::Max(NumTicks, 1);
+
+	//parse the output and baseline paths
+	FString OutputPath = FPaths::ProjectSavedDir() / TEXT("Benchmarks/RopeBenchmark.csv");
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+	FString BaselinePath = FPaths::ProjectConfigDir() / TEXT("Benchmarks/RopeBenchmarkBaseline.csv");
+	FParse::Value(*Params, TEXT("Baseline="), BaselinePath);
+
+	//parse the allowed regression (in percent) and whether to overwrite the baseline
+	float Threshold = 10.f;
+	FParse::Value(*Params, TEXT("Threshold="), Threshold);
+	const bool bUpdateBaseline = FParse::Param(*Params, TEXT("UpdateBaseline"));
+
+	//the scenarios and rope settings to sweep
+	static const TCHAR* Scenarios[] = { TEXT("OpenAir"), TEXT("PillarForest"), TEXT("CorridorWrap"), TEXT("MovingGrappleable") };
+	static const int32 VerletPointCounts[] = { 25, 100, 250 };
+	static const int32 ConstraintIterationCounts[] = { 5, 25 };
+
+	//run all the configurations
+	TArray<FRopeBenchmarkResult> Results;
+	for (const TCHAR* Scenario : Scenarios)
+	{
+		//run the pivot only rope once (the verlet settings don't affect it)
+		Results.Add(RunBenchmark(Scenario, 0, 0, false));
+
+		//run the verlet rope with every combination of settings
+		for (const int32 NumVerletPoints : VerletPointCounts)
+		{
+			for (const int32 NumConstraintIterations : ConstraintIterationCounts)
+			{
+				Results.Add(RunBenchmark(Scenario, NumVerletPoints, NumConstraintIterations, true));
+			}
+		}
+	}
+
+	//write the results
+	if (!WriteResults(OutputPath, Results))
+	{
+		UE_LOG(LogTemp, Error, TEXT("RopeBenchmark: failed to write results to %s"), *OutputPath);
+		return 1;
+	}
+
+	//print the results
+	UE_LOG(LogTemp, Display, TEXT("RopeBenchmark: wrote %d results to %s"), Results.Num(), *OutputPath);
+
+	//check if we should overwrite the baseline instead of comparing against it
+	if (bUpdateBaseline)
+	{
+		//write the baseline
+		const bool bWroteBaseline = WriteResults(BaselinePath, Results);
+		UE_LOG(LogTemp, Display, TEXT("RopeBenchmark: %s baseline %s"), bWroteBaseline ? TEXT("updated") : TEXT("failed to update"), *BaselinePath);
+		return bWroteBaseline ? 0 : 1;
+	}
+
+	//read the baseline
+	TMap<FString, FRopeBenchmarkResult> Baseline;
+	if (!ReadBaseline(BaselinePath, Baseline))
+	{
+		//check if there's a baseline file we couldn't read (a broken baseline shouldn't be overwritten silently)
+		if (IFileManager::Get().FileExists(*BaselinePath))
+		{
+			UE_LOG(LogTemp, Error, TEXT("RopeBenchmark: failed to read the baseline at %s, fix it or recapture it with -UpdateBaseline"), *BaselinePath);
+			return 1;
+		}
+
+		//write this run as the baseline (the first run on a machine has nothing to compare against)
+		const bool bWroteBaseline = WriteResults(BaselinePath, Results);
+		UE_LOG(LogTemp, Warning, TEXT("RopeBenchmark: no baseline at %s, %s this run as the baseline"), *BaselinePath, bWroteBaseline ? TEXT("wrote") : TEXT("failed to write"));
+		return bWroteBaseline ? 0 : 1;
+	}
+
+	//compare the results against the baseline
+	int32 NumRegressions = 0;
+	int32 NumMissing = 0;
+	for (const FRopeBenchmarkResult& Result : Results)
+	{
+		//check if the baseline has this configuration
+		const FRopeBenchmarkResult* BaselineResult = Baseline.Find(Result.GetKey());
+		if (!BaselineResult)
+		{
+			UE_LOG(LogTemp, Error, TEXT("RopeBenchmark: %s is missing from the baseline"), *Result.GetKey());
+			++NumMissing;
+			continue;
+		}
+
+		//check if we're slower than the baseline by more than the threshold
+		if (IsRegression(Result.MsPerTick, BaselineResult->MsPerTick, Threshold))
+		{
+			UE_LOG(LogTemp, Error, TEXT("RopeBenchmark: %s regressed from %.4f ms to %.4f ms per tick"), *Result.GetKey(), BaselineResult->MsPerTick, Result.MsPerTick);
+			++NumRegressions;
+		}
+
+		//check if we issue more scene queries than the baseline (machine independent)
+		if (IsRegression(Result.SceneQueriesPerTick, BaselineResult->SceneQueriesPerTick, Threshold))
+		{
+			UE_LOG(LogTemp, Error, TEXT("RopeBenchmark: %s regressed from %.2f to %.2f scene queries per tick"), *Result.GetKey(), BaselineResult->SceneQueriesPerTick, Result.SceneQueriesPerTick);
+			++NumRegressions;
+		}
+
+		//check if we allocate more than the baseline (machine independent)
+		if (IsRegression(Result.AllocationsPerTick, BaselineResult->AllocationsPerTick, Threshold))
+		{
+			UE_LOG(LogTemp, Error, TEXT("RopeBenchmark: %s regressed from %.2f to %.2f allocations per tick"), *Result.GetKey(), BaselineResult->AllocationsPerTick, Result.AllocationsPerTick);
+			++NumRegressions;
+		}
+	}
+
+	//print the summary
+	UE_LOG(LogTemp, Display, TEXT("RopeBenchmark: %d regression(s) over %.1f%%, %d run(s) missing from the baseline"), NumRegressions, Threshold, NumMissing);
+
+	return NumRegressions > 0 || NumMissing > 0 ? 1 : 0;
+}
+
+FVector URopeBenchmarkCommandlet::SpawnScenario(UWorld* World, const FString& Scenario, AActor*& OutMovingActor)
+{
+	OutMovingActor = nullptr;
+
+	//check if we're in the pillar forest
+	if (Scenario == TEXT("PillarForest"))
+	{
+		//spawn a grid of pillars around the owner's path
+		for (int X = -2; X <= 2; ++X)
+		{
+			for (int Y = -2; Y <= 2; ++Y)
+			{
+				SpawnBox(World, FVector(X * 600, Y * 600, 1000), FVector(100, 100, 2000), false);
+			}
+		}
+
+		//spawn the ceiling to grapple to
+		SpawnBox(World, FVector(0, 0, 2600), FVector(4000, 4000, 100), false);
+		return FVector(0, 0, 2600);
+	}
+
+	//check if we're in the corridor
+	if (Scenario == TEXT("CorridorWrap"))
+	{
+		//spawn the wall the rope wraps around and the far side of the corridor
+		SpawnBox(World, FVector(0, 0, 500), FVector(100, 2000, 1000), false);
+		SpawnBox(World, FVector(-1600, 0, 500), FVector(100, 8000, 1000), false);
+
+		//spawn the block to grapple to behind the wall
+		SpawnBox(World, FVector(800, 0, 500), FVector(200, 200, 200), false);
+		return FVector(800, 0, 500);
+	}
+
+	//check if we're grappling to a moving grappleable
+	if (Scenario == TEXT("MovingGrappleable"))
+	{
+		//spawn a pillar for the rope to wrap around
+		SpawnBox(World, FVector(400, 0, 1000), FVector(100, 100, 2000), false);
+
+		//spawn the moving block to grapple to
+		OutMovingActor = SpawnBox(World, FVector(0, 0, 2500), FVector(200, 200, 200), true);
+
+		//add a grappleable component to the block
+		UGrappleableComponent* GrappleableComponent = NewObject<UGrappleableComponent>(OutMovingActor);
+		GrappleableComponent->SetupAttachment(OutMovingActor->GetRootComponent());
+		GrappleableComponent->RegisterComponent();
+
+		return FVector(0, 0, 2500);
+	}
+
+	//default to open air with a single block to grapple to
+	SpawnBox(World, FVector(0, 0, 3000), FVector(200, 200, 200), false);
+	return FVector(0, 0, 3000);
+}
+
+FVector URopeBenchmarkCommandlet::GetOwnerLocation(const FString& Scenario, const float Time)
+{
+	//check if we're in the pillar forest (circle through the pillars)
+	if (Scenario == TEXT("PillarForest"))
+	{
+		return FVector(FMath::Cos(Time) * 1500, FMath::Sin(Time) * 1500, 200);
+	}
+
+	//check if we're in the corridor (walk down the corridor past the end of the wall and back)
+	if (Scenario == TEXT("CorridorWrap"))
+	{
+		return FVector(-800, -FMath::Cos(Time) * 3000, 500);
+	}
+
+	//check if we're grappling to a moving grappleable (sway slowly below it)
+	if (Scenario == TEXT("MovingGrappleable"))
+	{
+		return FVector(FMath::Sin(Time * 0.5f) * 600, 0, 0);
+	}
+
+	//default to swinging back and forth in open air
+	return FVector(FMath::Sin(Time) * 1500, 0, 0);
+}
+
+AActor* URopeBenchmarkCommandlet::SpawnBox(UWorld* World, const FVector& Location, const FVector& Size, const bool bMovable)
+{
+	//load the engine cube (100 units on each side)
+	static UStaticMesh* CubeMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+
+	//get the transform of the box
+	const FTransform Transform(FRotator::ZeroRotator, Location, Size / 100);
+
+	//spawn the box deferred so the mesh can be set before it's registered
+	AStaticMeshActor* Box = World->SpawnActorDeferred<AStaticMeshActor>(AStaticMeshActor::StaticClass(), Transform);
+	Box->GetStaticMeshComponent()->SetMobility(bMovable ? EComponentMobility::Movable : EComponentMobility::Static);
+	Box->GetStaticMeshComponent()->SetStaticMesh(CubeMesh);
+	Box->FinishSpawning(Transform);
+
+	return Box;
+}
+
+FRopeBenchmarkResult URopeBenchmarkCommandlet::RunBenchmark(const FString& Scenario, const int32 NumVerletPoints, const int32 NumConstraintIterations, const bool bUseVerletIntegration) const
+{
+	//setup the result
+	FRopeBenchmarkResult Result;
+	Result.Scenario = Scenario;
+	Result.NumVerletPoints = NumVerletPoints;
+	Result.NumConstraintIterations = NumConstraintIterations;
+	Result.bUseVerletIntegration = bUseVerletIntegration;
+
+	//create a world for the run
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("RopeBenchmark"));
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+
+	//spawn the scenario geometry
+	AActor* MovingActor = nullptr;
+	const FVector Target = SpawnScenario(World, Scenario, MovingActor);
+	const FVector MovingActorStart = MovingActor ? MovingActor->GetActorLocation() : FVector::ZeroVector;
+
+	//spawn the rope owner
+	AActor* Owner = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform(GetOwnerLocation(Scenario, 0)));
+
+	//create a constant curve for the constraint compensations
+	UCurveFloat* CompensationCurve = NewObject<UCurveFloat>(GetTransientPackage());
+	CompensationCurve->FloatCurve.AddKey(0, 0.5f);
+	CompensationCurve->FloatCurve.AddKey(1, 0.5f);
+
+	//create the rope (ticked manually so only the rope is timed)
+	URopeComponent* Rope = NewObject<URopeComponent>(Owner);
+	Rope->NumVerletPoints = FMath::Max(NumVerletPoints, 1);
+	Rope->NumConstraintIterations = NumConstraintIterations;
+	Rope->bUseVerletIntegration = bUseVerletIntegration;
+	Rope->ConstraintCompensation1Curve = CompensationCurve;
+	Rope->ConstraintCompensation2Curve = CompensationCurve;
+	Owner->SetRootComponent(Rope);
+	Rope->RegisterComponent();
+	Rope->SetComponentTickEnabled(false);
+
+	//tick the world once so the scene query structures are up to date
+	World->Tick(LEVELTICK_All, DeltaTime);
+
+	//trace to the grapple target and attach the rope
+	FHitResult Hit;
+	World->LineTraceSingleByChannel(Hit, Owner->GetActorLocation(), Target, Rope->CollisionChannel, Rope->GetCollisionParams());
+	if (Hit.IsValidBlockingHit())
+	{
+		Rope->ActivateRope(Hit);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("RopeBenchmark: %s couldn't reach its grapple target"), *Result.GetKey());
+	}
+
+	//the totals for the run
+	double TotalSeconds = 0;
+	int64 TotalSceneQueries = 0;
+	int64 TotalAllocations = 0;
+
+	//simulate the run
+	for (int Tick = 0; Tick < NumTicks; ++Tick)
+	{
+		//get the time of this tick
+		const float Time = Tick * DeltaTime;
+
+		//move the owner and the moving actor
+		Owner->SetActorLocation(GetOwnerLocation(Scenario, Time));
+		if (MovingActor)
+		{
+			MovingActor->SetActorLocation(MovingActorStart + FVector(FMath::Cos(Time) * 800, FMath::Sin(Time) * 800, 0));
+		}
+
+		//tick the world (the rope's tick is disabled)
+		World->Tick(LEVELTICK_All, DeltaTime);
+
+		//reset the counters
+		HiltProfiling::ResetCounters();
+
+		//time the rope tick (counting its allocations)
+		double TickSeconds;
+		{
+			HiltProfiling::FScopedAllocationCounter AllocationCounter;
+			const double StartTime = FPlatformTime::Seconds();
+			Rope->TickComponent(DeltaTime, LEVELTICK_All, &Rope->PrimaryComponentTick);
+			TickSeconds = FPlatformTime::Seconds() - StartTime;
+		}
+
+		//add to the totals
+		TotalSeconds += TickSeconds;
+		TotalSceneQueries += HiltProfiling::SceneQueries;
+		TotalAllocations += HiltProfiling::Allocations;
+		Result.MaxMsPerTick = FMath::Max(Result.MaxMsPerTick, TickSeconds * 1000);
+	}
+
+	//set the averages and the rope's reserved memory
+	Result.MsPerTick = TotalSeconds * 1000 / NumTicks;
+	Result.SceneQueriesPerTick = double(TotalSceneQueries) / NumTicks;
+	Result.AllocationsPerTick = double(TotalAllocations) / NumTicks;
+	Result.ReservedBytes = Rope->RopePoints.GetAllocatedSize() + Rope->Constraints.GetAllocatedSize() + Rope->CollisionPoints.GetAllocatedSize() + Rope->NiagaraComponents.GetAllocatedSize();
+
+	//print the result
+	UE_LOG(LogTemp, Display, TEXT("RopeBenchmark: %s %.4f ms/tick (max %.4f), %.1f queries/tick, %.2f allocations/tick, %lld bytes reserved"), *Result.GetKey(), Result.MsPerTick, Result.MaxMsPerTick, Result.SceneQueriesPerTick, Result.AllocationsPerTick, Result.ReservedBytes);
+
+	//tear down the world
+	Rope->DeactivateRope();
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	return Result;
+}
+
+bool URopeBenchmarkCommandlet::WriteResults(const FString& FilePath, const TArray<FRopeBenchmarkResult>& Results)
+{
+	//add the header
+	FString Csv = TEXT("Scenario,NumVerletPoints,NumConstraintIterations,CollisionMode,MsPerTick,MaxMsPerTick,SceneQueriesPerTick,AllocationsPerTick,ReservedBytes\n");
+
+	//add a row per result
+	for (const FRopeBenchmarkResult& Result : Results)
+	{
+		Csv += FString::Printf(TEXT("%s,%d,%d,%s,%.4f,%.4f,%.2f,%.2f,%lld\n"), *Result.Scenario, Result.NumVerletPoints, Result.NumConstraintIterations, Result.bUseVerletIntegration ? TEXT("Verlet") : TEXT("Pivot"), Result.MsPerTick, Result.MaxMsPerTick, Result.SceneQueriesPerTick, Result.AllocationsPerTick, Result.ReservedBytes);
+	}
+
+	return FFileHelper::SaveStringToFile(Csv, *FilePath);
+}
+
+bool URopeBenchmarkCommandlet::ReadBaseline(const FString& FilePath, TMap<FString, FRopeBenchmarkResult>& OutBaseline)
+{
+	//load the lines of the file
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *FilePath))
+	{
+		return false;
+	}
+
+	//iterate through the rows (skipping the header)
+	for (int Index = 1; Index < Lines.Num(); ++Index)
+	{
+		//split the row into columns
+		TArray<FString> Columns;
+		Lines[Index].ParseIntoArray(Columns, TEXT(","));
+
+		//check if the row is incomplete
+		if (Columns.Num() < 9)
+		{
+			continue;
+		}
+
+		//add the result keyed the same way as the results
+		FRopeBenchmarkResult& Result = OutBaseline.Add(FString::Printf(TEXT("%s|%s|%s|%s"), *Columns[0], *Columns[1], *Columns[2], *Columns[3]));
+		Result.MsPerTick = FCString::Atod(*Columns[4]);
+		Result.MaxMsPerTick = FCString::Atod(*Columns[5]);
+		Result.SceneQueriesPerTick = FCString::Atod(*Columns[6]);
+		Result.AllocationsPerTick = FCString::Atod(*Columns[7]);
+		Result.ReservedBytes = FCString::Atoi64(*Columns[8]);
+	}
+
+	//check if the baseline has any rows
+	return !OutBaseline.IsEmpty();
+}
+
+bool URopeBenchmarkCommandlet::IsRegression(const double Value, const double BaselineValue, const float Threshold)
+{
+	//check if the value is over the baseline by more than the threshold (a baseline of 0 doesn't allow any)
+	return Value > BaselineValue * (1 + Threshold / 100) + KINDA_SMALL_NUMBER;
+}
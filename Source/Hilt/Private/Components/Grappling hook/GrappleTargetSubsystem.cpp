@@ -0,0 +1,254 @@
+#include "Components/GrapplingHook/GrappleTargetSubsystem.h"
+
+#include "NPC/Components/GrappleableComponent.h"
+
+void UGrappleTargetSubsystem::RegisterTarget(UGrappleableComponent* Target)
+{
+	//check if the target is invalid or already registered
+	if (!Target || TargetCells.Contains(Target))
+	{
+		return;
+	}
+
+	//get the cell of the target
+	const FIntVector Cell = GetCell(Target->GetComponentLocation());
+
+	//add the target to the cell
+	Cells.FindOrAdd(Cell).Add(Target);
+	TargetCells.Add(Target, Cell);
+
+	//make the target the grappleable component of its owner (the first registered one wins if the owner has several)
+	if (const AActor* Owner = Target->GetOwner(); Owner && !TargetOwners.Contains(Owner))
+	{
+		TargetOwners.Add(Owner, Target);
+	}
+}
+
+void UGrappleTargetSubsystem::UnregisterTarget(UGrappleableComponent* Target)
+{
+	//get the cell of the target and check if it's registered
+	FIntVector Cell;
+	if (!TargetCells.RemoveAndCopyValue(Target, Cell))
+	{
+		return;
+	}
+
+	//remove the target from its cell
+	RemoveFromCell(Target, Cell);
+
+	//check if the target was the grappleable component of its owner
+	const AActor* Owner = Target->GetOwner();
+	if (!Owner || TargetOwners.FindRef(Owner) != Target)
+	{
+		return;
+	}
+
+	//remove the owner
+	TargetOwners.Remove(Owner);
+
+	//use another registered grappleable component of the owner if it has one
+	Owner->ForEachComponent<UGrappleableComponent>(false, [&](UGrappleableComponent* Other)
+	{
+		if (Other != Target && TargetCells.Contains(Other) && !TargetOwners.Contains(Owner))
+		{
+			TargetOwners.Add(Owner, Other);
+		}
+	});
+}
+
+FGrappleableMetadata UGrappleTargetSubsystem::GetMetadata(const UPrimitiveComponent* Primitive) const
+{
+	//copy the current values of the primitive owner's grappleable component (empty if it isn't grappleable)
+	FGrappleableMetadata Metadata;
+	FillMetadata(Primitive ? FindGrappleable(Primitive->GetOwner()) : nullptr, Metadata);
+
+	return Metadata;
+}
+
+void UGrappleTargetSubsystem::FillMetadata(const UGrappleableComponent* Target, FGrappleableMetadata& OutMetadata)
+{
+	//reset the metadata
+	OutMetadata = FGrappleableMetadata();
+
+	//check if there's no grappleable component
+	if (!Target)
+	{
+		return;
+	}
+
+	//copy the values the grapple reads every tick
+	OutMetadata.Grappleable = const_cast<UGrappleableComponent*>(Target);
+	OutMetadata.InterpStructPlayer = Target->GetGrappleInterpStruct();
+	OutMetadata.bUseGrappleInterpStruct = Target->ShouldUseGrappleInterpStruct();
+	OutMetadata.bCanChangeGrappleMode = Target->CanChangeGrappleMode();
+	OutMetadata.bNormalMovement = Target->NormalMovement;
+	OutMetadata.ReelForceMultiplierPlayer = Target->GrappleReelForceMultiplierPlayer;
+	OutMetadata.MaxSpeedPlayer = Target->MaxSpeedPlayer;
+}
+
+UGrappleableComponent* UGrappleTargetSubsystem::FindBestTarget(const FVector& ViewLocation, const FVector& ViewDirection, const float MaxDistance, const float MaxAngleDegrees, const float AngleWeight, const AActor* IgnoredActor) const
+{
+	//get the cone angle values
+	const float MaxAngleRadians = FMath::DegreesToRadians(FMath::Clamp(MaxAngleDegrees, 0.f, 89.f));
+	const float MinCosAngle = FMath::Cos(MaxAngleRadians);
+
+	//storage for the best target
+	UGrappleableComponent* BestTarget = nullptr;
+	float BestScore = MAX_flt;
+
+	//get the bounds of the cone (the radius of the far end of the cone around the line from the view location)
+	const FVector FarCenter = ViewLocation + ViewDirection * MaxDistance;
+	const float ConeRadius = FMath::Min(MaxDistance * FMath::Tan(MaxAngleRadians), MaxDistance);
+	const FBox ConeBounds = FBox(ViewLocation.ComponentMin(FarCenter), ViewLocation.ComponentMax(FarCenter)).ExpandBy(ConeRadius);
+
+	//get the cells the cone overlaps
+	const FIntVector MinCell = GetCell(ConeBounds.Min);
+	const FIntVector MaxCell = GetCell(ConeBounds.Max);
+	const int64 NumCells = int64(MaxCell.X - MinCell.X + 1) * (MaxCell.Y - MinCell.Y + 1) * (MaxCell.Z - MinCell.Z + 1);
+
+	//check if it's cheaper to check every target than to visit every cell
+	if (NumCells > TargetCells.Num())
+	{
+		//iterate through all the targets
+		for (const TPair<UGrappleableComponent*, FIntVector>& TargetCell : TargetCells)
+		{
+			//score the target and check if it's the best one so far
+			if (float Score = 0; ScoreTarget(TargetCell.Key, ViewLocation, ViewDirection, MaxDistance, MinCosAngle, MaxAngleRadians, AngleWeight, IgnoredActor, Score) && Score < BestScore)
+			{
+				BestScore = Score;
+				BestTarget = TargetCell.Key;
+			}
+		}
+
+		return BestTarget;
+	}
+
+	//iterate through the cells the cone overlaps
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+			{
+				//get the targets in this cell
+				const TArray<UGrappleableComponent*>* CellTargets = Cells.Find(FIntVector(X, Y, Z));
+				if (!CellTargets)
+				{
+					continue;
+				}
+
+				//iterate through the targets in this cell
+				for (UGrappleableComponent* Target : *CellTargets)
+				{
+					//score the target and check if it's the best one so far
+					if (float Score = 0; ScoreTarget(Target, ViewLocation, ViewDirection, MaxDistance, MinCosAngle, MaxAngleRadians, AngleWeight, IgnoredActor, Score) && Score < BestScore)
+					{
+						BestScore = Score;
+						BestTarget = Target;
+					}
+				}
+			}
+		}
+	}
+
+	return BestTarget;
+}
+
+void UGrappleTargetSubsystem::Tick(float DeltaTime)
+{
+	//iterate through all the targets
+	for (TPair<UGrappleableComponent*, FIntVector>& TargetCell : TargetCells)
+	{
+		//get the cell the target is in now and check if it moved to another cell
+		const FIntVector NewCell = GetCell(TargetCell.Key->GetComponentLocation());
+		if (NewCell == TargetCell.Value)
+		{
+			continue;
+		}
+
+		//move the target to the new cell
+		RemoveFromCell(TargetCell.Key, TargetCell.Value);
+		Cells.FindOrAdd(NewCell).Add(TargetCell.Key);
+		TargetCell.Value = NewCell;
+	}
+}
+
+TStatId UGrappleTargetSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGrappleTargetSubsystem, STATGROUP_Tickables);
+}
+
+void UGrappleTargetSubsystem::Deinitialize()
+{
+	//clear the hash
+	Cells.Empty();
+	TargetCells.Empty();
+	TargetOwners.Empty();
+
+	//call the parent implementation
+	Super::Deinitialize();
+}
+
+bool UGrappleTargetSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	//only track targets in worlds that are played
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+FIntVector UGrappleTargetSubsystem::GetCell(const FVector& Location)
+{
+	return FIntVector(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize), FMath::FloorToInt(Location.Z / CellSize));
+}
+
+void UGrappleTargetSubsystem::RemoveFromCell(UGrappleableComponent* Target, const FIntVector& Cell)
+{
+	//get the targets in the cell
+	TArray<UGrappleableComponent*>* CellTargets = Cells.Find(Cell);
+	if (!CellTargets)
+	{
+		return;
+	}
+
+	//remove the target (order doesn't matter)
+	CellTargets->RemoveSingleSwap(Target);
+
+	//remove the cell if it's empty
+	if (CellTargets->IsEmpty())
+	{
+		Cells.Remove(Cell);
+	}
+}
+
+bool UGrappleTargetSubsystem::ScoreTarget(const UGrappleableComponent* Target, const FVector& ViewLocation, const FVector& ViewDirection, const float MaxDistance, const float MinCosAngle, const float MaxAngleRadians, const float AngleWeight, const AActor* IgnoredActor, float& OutScore)
+{
+	//check if the target belongs to the ignored actor
+	if (IgnoredActor && Target->GetOwner() == IgnoredActor)
+	{
+		return false;
+	}
+
+	//get the offset to the target and check if it's out of range
+	const FVector Offset = Target->GetComponentLocation() - ViewLocation;
+	const float DistanceSquared = Offset.SizeSquared();
+	if (DistanceSquared > FMath::Square(MaxDistance) || DistanceSquared < KINDA_SMALL_NUMBER)
+	{
+		return false;
+	}
+
+	//get the cosine of the angle to the target and check if it's outside the cone
+	const float Distance = FMath::Sqrt(DistanceSquared);
+	const float CosAngle = FVector::DotProduct(Offset / Distance, ViewDirection);
+	if (CosAngle < MinCosAngle)
+	{
+		return false;
+	}
+
+	//get the normalized angle and distance
+	const float NormalizedAngle = MaxAngleRadians > 0 ? FMath::Acos(FMath::Min(CosAngle, 1.f)) / MaxAngleRadians : 0;
+	const float NormalizedDistance = Distance / MaxDistance;
+
+	//blend the angle and distance into the score
+	OutScore = NormalizedAngle * AngleWeight + NormalizedDistance * (1 - AngleWeight);
+
+	return true;
+}
@@ -0,0 +1,189 @@
+#include "Components/GrapplingHook/GrappleVisibilitySubsystem.h"
+
+#include "HAL/PlatformFileManager.h"
+#include "Misc/PackageName.h"
+
+FString UGrappleVisibilitySubsystem::GetBakePath(const FString& LevelPackageName)
+{
+	//the files are staged as loose files so they can be memory-mapped (see DirectoriesToAlwaysStageAsNonUFS)
+	return FPaths::ProjectContentDir() / TEXT("GrappleVisibility") / FPackageName::GetShortName(LevelPackageName) + TEXT(".hgv");
+}
+
+int32 UGrappleVisibilitySubsystem::DirectionToBin(const FVector& Direction)
+{
+	//get the length of the direction on the octahedron
+	const double Length = FMath::Abs(Direction.X) + FMath::Abs(Direction.Y) + FMath::Abs(Direction.Z);
+	if (Length < KINDA_SMALL_NUMBER)
+	{
+		return 0;
+	}
+
+	//project the direction onto the octahedron
+	double U = Direction.X / Length;
+	double V = Direction.Y / Length;
+
+	//check if the direction is in the lower hemisphere
+	if (Direction.Z < 0)
+	{
+		//fold the lower hemisphere over the corners of the map
+		const double OldU = U;
+		U = (1 - FMath::Abs(V)) * (OldU >= 0 ? 1 : -1);
+		V = (1 - FMath::Abs(OldU)) * (V >= 0 ? 1 : -1);
+	}
+
+	//get the bin coordinates
+	const int32 X = FMath::Clamp(FMath::FloorToInt32((U * 0.5 + 0.5) * BinsPerSide), 0, BinsPerSide - 1);
+	const int32 Y = FMath::Clamp(FMath::FloorToInt32((V * 0.5 + 0.5) * BinsPerSide), 0, BinsPerSide - 1);
+
+	return Y * BinsPerSide + X;
+}
+
+FVector UGrappleVisibilitySubsystem::BinToDirection(const int32 Bin, const float OffsetU, const float OffsetV)
+{
+	//get the position of the bin on the map (-1 to 1)
+	const double U = ((Bin % BinsPerSide) + 0.5 + OffsetU) / BinsPerSide * 2 - 1;
+	const double V = ((Bin / BinsPerSide) + 0.5 + OffsetV) / BinsPerSide * 2 - 1;
+
+	//get the point on the octahedron
+	FVector Direction(U, V, 1 - FMath::Abs(U) - FMath::Abs(V));
+
+	//check if the point is in the lower hemisphere
+	if (Direction.Z < 0)
+	{
+		//unfold the corners of the map back into the lower hemisphere
+		const double OldX = Direction.X;
+		Direction.X = (1 - FMath::Abs(Direction.Y)) * (OldX >= 0 ? 1 : -1);
+		Direction.Y = (1 - FMath::Abs(OldX)) * (Direction.Y >= 0 ? 1 : -1);
+	}
+
+	return Direction.GetSafeNormal();
+}
+
+bool UGrappleVisibilitySubsystem::GetMaxVisibleDistance(const FVector& Location, const FVector& Direction, const float MaxDistance, float& OutDistance) const
+{
+	//check if we have no data or the data wasn't baked far enough
+	if (!Header || MaxDistance > Header->MaxDistance)
+	{
+		return false;
+	}
+
+	//get the cell the location is in
+	const FVector Local = (Location - FVector(Header->Origin)) / Header->CellSize;
+	const FIntVector Cell(FMath::FloorToInt32(Local.X), FMath::FloorToInt32(Local.Y), FMath::FloorToInt32(Local.Z));
+
+	//check if the location is outside the grid
+	if (Cell.X < 0 || Cell.Y < 0 || Cell.Z < 0 || Cell.X >= Header->Dimensions.X || Cell.Y >= Header->Dimensions.Y || Cell.Z >= Header->Dimensions.Z)
+	{
+		return false;
+	}
+
+	//get the baked distances of the cell
+	const int64 CellIndex = (int64(Cell.Z) * Header->Dimensions.Y + Cell.Y) * Header->Dimensions.X + Cell.X;
+	const uint8* CellValues = CellData + CellIndex * NumBins;
+
+	//get the bin of the direction
+	const int32 Bin = DirectionToBin(Direction);
+	const int32 BinX = Bin % BinsPerSide;
+	const int32 BinY = Bin / BinsPerSide;
+
+	//get the farthest baked distance of the bin and its neighbours (the bake only samples a few rays per bin, so a surface between them can be farther than the bin's own value)
+	uint8 MaxValue = 0;
+	for (int32 Y = FMath::Max(BinY - 1, 0); Y <= FMath::Min(BinY + 1, BinsPerSide - 1); ++Y)
+	{
+		for (int32 X = FMath::Max(BinX - 1, 0); X <= FMath::Min(BinX + 1, BinsPerSide - 1); ++X)
+		{
+			//check if nothing was hit in this bin (a ray got past every static surface nearby)
+			const uint8 Value = CellValues[Y * BinsPerSide + X];
+			if (Value == 0)
+			{
+				OutDistance = 0;
+				return true;
+			}
+
+			MaxValue = FMath::Max(MaxValue, Value);
+		}
+	}
+
+	//decode the distance and add the farthest the location can be from where the cell was sampled, a cell of margin and the rounding of the distance
+	OutDistance = FMath::Min((MaxValue + 1) / 255.f * Header->MaxDistance + Header->CellSize * (0.5f * FMath::Sqrt(3.f) + 1), MaxDistance);
+	return true;
+}
+
+void UGrappleVisibilitySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	//call the parent implementation
+	Super::OnWorldBeginPlay(InWorld);
+
+	//get the path of the baked file for this level
+	const FString Path = GetBakePath(UWorld::RemovePIEPrefix(InWorld.GetOutermost()->GetName()));
+
+	//check if the level has been baked
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (!PlatformFile.FileExists(*Path))
+	{
+		return;
+	}
+
+	//map the file
+	MappedFile.Reset(PlatformFile.OpenMapped(*Path));
+	if (MappedFile)
+	{
+		MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+	}
+
+	//check if the file couldn't be mapped
+	if (!MappedRegion || MappedRegion->GetMappedSize() < sizeof(FGrappleVisibilityHeader))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("GrappleVisibility: failed to map %s"), *Path);
+		Unmap();
+		return;
+	}
+
+	//get the header and check that it matches this version
+	const FGrappleVisibilityHeader* MappedHeader = reinterpret_cast<const FGrappleVisibilityHeader*>(MappedRegion->GetMappedPtr());
+	if (MappedHeader->Magic != FileMagic || MappedHeader->Version != FileVersion || MappedHeader->NumBins != NumBins || MappedHeader->CellSize <= 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("GrappleVisibility: %s is out of date, rebake it with -run=GrappleVisibilityBake"), *Path);
+		Unmap();
+		return;
+	}
+
+	//check that the file has all the cells
+	const int64 NumCells = int64(MappedHeader->Dimensions.X) * MappedHeader->Dimensions.Y * MappedHeader->Dimensions.Z;
+	if (NumCells <= 0 || MappedRegion->GetMappedSize() < sizeof(FGrappleVisibilityHeader) + NumCells * NumBins)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("GrappleVisibility: %s is truncated"), *Path);
+		Unmap();
+		return;
+	}
+
+	//use the mapped data
+	Header = MappedHeader;
+	CellData = MappedRegion->GetMappedPtr() + sizeof(FGrappleVisibilityHeader);
+}
+
+void UGrappleVisibilitySubsystem::Deinitialize()
+{
+	//release the mapped file
+	Unmap();
+
+	//call the parent implementation
+	Super::Deinitialize();
+}
+
+bool UGrappleVisibilitySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	//only load the data in worlds that are played
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UGrappleVisibilitySubsystem::Unmap()
+{
+	//clear the pointers into the region
+	Header = nullptr;
+	CellData = nullptr;
+
+	//release the region before the file
+	MappedRegion.Reset();
+	MappedFile.Reset();
+}
@@ -4,7 +4,12 @@
 #include "NPC/Components/GrappleableComponent.h"
 #include "Components/PlayerMovementComponent.h"
 #include "Components/Camera/PlayerCameraComponent.h"
+#include "Components/GrapplingHook/GrappleTargetSubsystem.h"
+#include "Components/GrapplingHook/GrappleVisibilitySubsystem.h"
 #include "Components/GrapplingHook/RopeComponent.h"
+#include "Core/HiltProfiling.h"
+#include "Core/HiltSimulationSubsystem.h"
+#include "Core/Math/BakedCurve.h"
 #include "Player/PlayerCharacter.h"
 #include "Player/ScoreComponent.h"
 
@@ -29,9 +34,50 @@ void UGrapplingComponent::BeginPlay()
 	//get the owner as a player character
 	PlayerCharacter = Cast<APlayerCharacter>(GetOwner());
 
+	//tick after the player's movement so the frame context is resolved from this frame's movement
+	AddTickPrerequisiteComponent(PlayerCharacter->PlayerMovementComponent);
+
 	//setup start and stop grapple events for the rope component
 	OnStartGrapple.AddDynamic(RopeComponent, &URopeComponent::ActivateRope);
 	OnStopGrapple.AddDynamic(RopeComponent, &URopeComponent::DeactivateRope);
+
+	//cache the score values of the current score tier and recache them whenever it changes
+	PlayerCharacter->ScoreComponent->OnScoreTierChanged.AddDynamic(this, &UGrapplingComponent::OnScoreTierChanged);
+	OnScoreTierChanged(PlayerCharacter->ScoreComponent->ScoreTier, PlayerCharacter->ScoreComponent->ScoreTier);
+
+	//bind the async availability trace delegate
+	AvailabilityTraceDelegate.BindUObject(this, &UGrapplingComponent::OnAvailabilityTraceDone);
+
+	//allocate the preview paths up front so simulating them doesn't allocate
+	PreviewPath.Reserve(PreviewNumSteps + 1);
+	PreviewBackBuffer.Reserve(PreviewNumSteps + 1);
+
+	//bake the curves we evaluate every tick (the preview's worker thread reads the baked tables)
+	HiltCurves::BakeReferencedCurves(this);
+
+	//finish the preview before every garbage collection (the baked tables it reads can be freed after it)
+	PreGarbageCollectHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddUObject(this, &UGrapplingComponent::WaitForPreviewTask);
+}
+
+void UGrapplingComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	//stop waiting for the preview before garbage collection
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGarbageCollectHandle);
+
+	//wait for the preview simulation to finish (it writes to this component)
+	WaitForPreviewTask();
+
+	//call the parent implementation
+	Super::EndPlay(EndPlayReason);
+}
+
+void UGrapplingComponent::WaitForPreviewTask()
+{
+	//check if the preview is being simulated
+	if (PreviewTask.IsValid())
+	{
+		PreviewTask.Wait();
+	}
 }
 
 void UGrapplingComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
@@ -39,17 +85,27 @@ void UGrapplingComponent::TickComponent(float DeltaTime, ELevelTick TickType, FA
 	//call the parent implementation
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
-	//update the can grapple variable
-	CanGrappleVar = CanGrapple(false);
+	//resolve the values the grapple reads this tick
+	UpdateFrameContext();
+
+	//start the async trace that updates the can grapple variable next frame
+	RequestAvailabilityTrace();
+
+	//check if we should predict the path of the grapple
+	if (bShowTrajectoryPreview)
+	{
+		//update the trajectory preview
+		UpdateTrajectoryPreview();
+	}
 
 	//check if we're grappling
 	if (bIsGrappling)
 	{
 		//assign the grapple direction
-		GrappleDirection = RopeComponent->GetRopeDirection().GetSafeNormal();
+		GrappleDirection = FrameContext.GrappleDirection;
 
-		//apply the pull force
-		ApplyPullForce(DeltaTime);
+		//apply the pull force in fixed steps
+		ApplyFixedStepPullForce(DeltaTime);
 
 		//check that we're not grounded
 		if (!PlayerCharacter->PlayerMovementComponent->IsMovingOnGround() && -GrappleDirection.GetSafeNormal().Z < PlayerCharacter->PlayerMovementComponent->GetWalkableFloorZ())
@@ -70,14 +126,14 @@ void UGrapplingComponent::TickComponent(float DeltaTime, ELevelTick TickType, FA
 		if (GrappleScoreCurve)
 		{
 			//get the grapple score curve value
-			const float Value = GrappleScoreCurve->GetFloatValue(GetWorld()->GetTimeSeconds() - GrappleStartTime);
+			const float Value = HiltCurves::Evaluate(GrappleScoreCurve, UHiltSimulationSubsystem::GetGameplayTime(this) - GrappleStartTime);
 
 			//set the pending score
-			PendingScore = Value * PlayerCharacter->ScoreComponent->GetCurrentScoreValues().ScoreGainMultiplier;
+			PendingScore = Value * FrameContext.ScoreValues.ScoreGainMultiplier;
 		}
 
 		//check if the grapple start time + GrappleScoreDecayStopDelay is less than the current time
-		if (GrappleStartTime + GrappleScoreDecayStopDelay < GetWorld()->GetTimeSeconds())
+		if (GrappleStartTime + GrappleScoreDecayStopDelay < UHiltSimulationSubsystem::GetGameplayTime(this))
 		{
 			//stop the score degredation timer
 			PlayerCharacter->ScoreComponent->StopDegredationTimer();
@@ -137,8 +193,18 @@ void UGrapplingComponent::StartGrapple(const FHitResult& HitResult)
 	//update bIsGrappling
 	bIsGrappling = true;
 
+	//get the current grapple values of the hit component (the grappleable component is found through the registered targets instead of iterating the actor's components)
+	if (UGrappleTargetSubsystem* GrappleTargetSubsystem = GetWorld()->GetSubsystem<UGrappleTargetSubsystem>())
+	{
+		GrappleableMetadata = GrappleTargetSubsystem->GetMetadata(HitResult.GetComponent());
+	}
+	else
+	{
+		UGrappleTargetSubsystem::FillMetadata(HitResult.GetActor()->FindComponentByClass<UGrappleableComponent>(), GrappleableMetadata);
+	}
+
 	//check if the other actor has a grappleable component
-	if (GrappleableComponent = HitResult.GetActor()->GetComponentByClass<UGrappleableComponent>(); GrappleableComponent->IsValidLowLevelFast())
+	if (GrappleableComponent = GrappleableMetadata.Grappleable; GrappleableComponent->IsValidLowLevelFast())
 	{
 		//set bisgrappled to true
 		GrappleableComponent->bIsGrappled = true;
@@ -147,6 +213,10 @@ void UGrapplingComponent::StartGrapple(const FHitResult& HitResult)
 		OnStartGrapple.AddDynamic(GrappleableComponent, &UGrappleableComponent::OnStartGrapple);
 		OnStopGrapple.AddDynamic(GrappleableComponent, &UGrappleableComponent::OnStopGrapple);
 	}
+
+	//resolve the frame context for the new rope (after the grappleable values, the speed limit depends on them)
+	UpdateFrameContext();
+
 	//check if we shouldn't use normal movement
 	if (!ShouldUseNormalMovement())
 	{
@@ -166,10 +236,13 @@ void UGrapplingComponent::StartGrapple(const FHitResult& HitResult)
 	else
 	{
 		//set the gravity scale back to normal
-		PlayerCharacter->PlayerMovementComponent->GravityScale = PlayerCharacter->ScoreComponent->GetCurrentScoreValues().GravityScale;
+		PlayerCharacter->PlayerMovementComponent->GravityScale = FrameContext.ScoreValues.GravityScale;
 	}
 
-	GrappleStartTime = GetWorld()->GetTimeSeconds();
+	GrappleStartTime = UHiltSimulationSubsystem::GetGameplayTime(this);
+
+	//reset the fixed step accumulator
+	PullTimeAccumulator = 0;
 
 	//call the OnStartGrapple event
 	OnStartGrapple.Broadcast(HitResult);
@@ -205,7 +278,7 @@ void UGrapplingComponent::StopGrapple(bool CallBlueprintEvent)
 	if (GrappleScoreCurve)
 	{
 		//get the grapple score curve value
-		const float Value = GrappleScoreCurve->GetFloatValue(GetWorld()->GetTimeSeconds() - GrappleStartTime);
+		const float Value = HiltCurves::Evaluate(GrappleScoreCurve, UHiltSimulationSubsystem::GetGameplayTime(this) - GrappleStartTime);
 
 		//set the pending score to 0
 		PendingScore = 0;
@@ -247,6 +320,10 @@ void UGrapplingComponent::StopGrapple(bool CallBlueprintEvent)
 		PlayerCharacter->PlayerMovementComponent->SetWalkableFloorAngle(PlayerCharacter->PlayerMovementComponent->GetWalkableFloorAngle() - 30);
 	}
 
+	//forget the grappleable values of the target (so the next grapple doesn't use them)
+	GrappleableComponent = nullptr;
+	GrappleableMetadata = FGrappleableMetadata();
+
 	//set borientrotationtoMovement to true
 	PlayerCharacter->PlayerMovementComponent->bOrientRotationToMovement = true;
 
@@ -260,12 +337,44 @@ void UGrapplingComponent::StopGrapple(bool CallBlueprintEvent)
 
 void UGrapplingComponent::StartGrappleCheck()
 {
-	//check if we're already grappling or if we can't grapple
-	if (bIsGrappling || !CanGrapple(true))
+	//check if we're already grappling
+	if (bIsGrappling)
 	{
 		//return early
 		return;
 	}
+
+	//check if the last availability result is still valid for where we're aiming
+	FHitResult AvailabilityHit;
+	if (bUseSameFrameGrapple && GetValidAvailabilityHit(AvailabilityHit))
+	{
+		//start grappling without doing another trace
+		StartGrapple(AvailabilityHit);
+
+		//start pulling this frame
+		ApplyFirstPullStep();
+
+		//return early
+		return;
+	}
+
+	//check if we can't grapple to where we're aiming with a line trace
+	if (!CanGrapple(false))
+	{
+		//check if the aim assist finds a grappleable target near the aim
+		if (FHitResult AimAssistHit; bUseAimAssist && FindAimAssistHit(AimAssistHit))
+		{
+			//use the aim assist hit
+			GrappleHits.Reset();
+			GrappleHits.Add(AimAssistHit);
+		}
+		//check if the sphere trace can't find anything either
+		else if (!CanGrapple(true))
+		{
+			//return early
+			return;
+		}
+	}
 	
 	//check if the line trace hit something
 	if (GrappleHits.IsEmpty())
@@ -282,12 +391,15 @@ void UGrapplingComponent::StartGrappleCheck()
 
 	//start grappling
 	StartGrapple(GrappleHits[0]);
+
+	//start pulling this frame
+	ApplyFirstPullStep();
 }
 
 void UGrapplingComponent::StopGrappleCheck()
 {
 	//check if we're close to the end of the rope
-	if (FVector::Dist(GetOwner()->GetActorLocation(), RopeComponent->GetRopeEnd()) < GrappleStopDistance)
+	if (FVector::Dist(FrameContext.OwnerLocation, FrameContext.RopeEnd) < GrappleStopDistance)
 	{
 		//stop grappling
 		StopGrapple();
@@ -330,53 +442,53 @@ FVector UGrapplingComponent::ProcessGrappleInput(FVector MovementInput)
 	}
 
 	//storage for the return vector
-	FVector ReturnVec = MovementInput * GrappleMovementInputModifier * PlayerCharacter->ScoreComponent->GetCurrentScoreValues().GrapplingInputModifier;
+	FVector ReturnVec = MovementInput * GrappleMovementInputModifier * FrameContext.ScoreValues.GrapplingInputModifier;
 
 	//check if we have valid angle input curve
-	if (PlayerCharacter->ScoreComponent->GetCurrentScoreValues().GrappleMovementAngleInputCurve)
+	if (FrameContext.ScoreValues.GrappleMovementAngleInputCurve)
 	{
 		//get the dot product of the current grapple direction and the return vector
 		const float DotProduct = FVector::DotProduct(PlayerCharacter->GetActorUpVector(),MovementInput.GetSafeNormal());
 
 		//get the grapple angle movement input curve value
-		const float Value = PlayerCharacter->ScoreComponent->GetCurrentScoreValues().GrappleMovementAngleInputCurve->GetFloatValue(DotProduct);
+		const float Value = HiltCurves::Evaluate(FrameContext.ScoreValues.GrappleMovementAngleInputCurve, DotProduct);
 
 		//multiply the return vector
 		ReturnVec *= Value;
 	}
 
 	//check if we have a valid grapple movement distance curve
-	if (PlayerCharacter->ScoreComponent->GetCurrentScoreValues().GrappleMovementDistanceInputCurve)
+	if (FrameContext.ScoreValues.GrappleMovementDistanceInputCurve)
 	{
 		//get the grapple distance movement input curve value
-		const float Value = PlayerCharacter->ScoreComponent->GetCurrentScoreValues().GrappleMovementDistanceInputCurve->GetFloatValue(FMath::Clamp(FVector::Dist(GetOwner()->GetActorLocation(), RopeComponent->GetRopeEnd()) / MaxGrappleDistance, 0, 1));
+		const float Value = HiltCurves::Evaluate(FrameContext.ScoreValues.GrappleMovementDistanceInputCurve, FrameContext.DistanceRatio);
 
 		//multiply the return 
 		ReturnVec *= Value;
 	}
 
 	//check if we have a valid GrappleMovementSpeedCurve
-	if (PlayerCharacter->ScoreComponent->GetCurrentScoreValues().GrappleMovementSpeedCurve)
+	if (FrameContext.ScoreValues.GrappleMovementSpeedCurve)
 	{
 		//get the grapple velocity movement input curve value
-		const float Value = PlayerCharacter->ScoreComponent->GetCurrentScoreValues().GrappleMovementSpeedCurve->GetFloatValue(PlayerCharacter->PlayerMovementComponent->ApplySpeedLimit(ReturnVec, DELTA, false).Size() / PlayerCharacter->PlayerMovementComponent->GetCurrentSpeedLimit());
+		const float Value = HiltCurves::Evaluate(FrameContext.ScoreValues.GrappleMovementSpeedCurve, FMath::Min(ReturnVec.Size(), FrameContext.SpeedLimit) / FrameContext.CurrentSpeedLimit);
 
 		//multiply the return vector
 		ReturnVec *= Value;
 	}
 
 	//check if we have a valid GrappleMovementDirectionCurve
-	if (PlayerCharacter->ScoreComponent->GetCurrentScoreValues().GrappleMovementDirectionCurve)
+	if (FrameContext.ScoreValues.GrappleMovementDirectionCurve)
 	{
 		//get the grapple direction movement input curve value
-		const float Value = PlayerCharacter->ScoreComponent->GetCurrentScoreValues().GrappleMovementDirectionCurve->GetFloatValue(FVector::DotProduct(ReturnVec.GetSafeNormal(), PlayerCharacter->PlayerMovementComponent->Velocity.GetSafeNormal()));
+		const float Value = HiltCurves::Evaluate(FrameContext.ScoreValues.GrappleMovementDirectionCurve, FVector::DotProduct(ReturnVec.GetSafeNormal(), FrameContext.VelocityDirection));
 
 		//multiply the return vector
 		ReturnVec *= Value;
 	}
 
 	//apply the speed limit to the return vector
-	ReturnVec = PlayerCharacter->PlayerMovementComponent->ApplySpeedLimit(ReturnVec, DELTA, false);
+	ReturnVec = ReturnVec.GetClampedToMaxSize(FrameContext.SpeedLimit);
 
 	//return the return vector
 	return ReturnVec;
@@ -384,11 +496,11 @@ FVector UGrapplingComponent::ProcessGrappleInput(FVector MovementInput)
 
 bool UGrapplingComponent::ShouldUseNormalMovement() const
 {
-	//check if we have a valid grappleable component
-	if (GrappleableComponent->IsValidLowLevelFast())
+	//check if we have a grappleable component
+	if (GrappleableMetadata.Grappleable)
 	{
 		//check if the grappleable component has normal movement enabled
-		if (GrappleableComponent->NormalMovement)
+		if (GrappleableMetadata.bNormalMovement)
 		{
 			return true;
 		}
@@ -400,14 +512,14 @@ bool UGrapplingComponent::ShouldUseNormalMovement() const
 
 float UGrapplingComponent::GetMaxSpeed() const
 {
-	//check if we have a valid grappleable component
-	if (GrappleableComponent->IsValidLowLevelFast())
+	//check if we have a grappleable component
+	if (GrappleableMetadata.Grappleable)
 	{
 		//check if the grappleable component has a max speed set
-		if (GrappleableComponent->MaxSpeedPlayer > 0)
+		if (GrappleableMetadata.MaxSpeedPlayer > 0)
 		{
 			//return the grappleable component's max speed
-			return GrappleableComponent->MaxSpeedPlayer;
+			return GrappleableMetadata.MaxSpeedPlayer;
 		}
 	}
 
@@ -417,26 +529,11 @@ float UGrapplingComponent::GetMaxSpeed() const
 
 void UGrapplingComponent::DoInterpGrapple(float DeltaTime, FVector& GrappleVelocity, FGrappleInterpStruct GrappleInterpStruct)
 {
-	//storage for the grapple direction
-	const FVector LocGrappleDirection = GrappleDirection.GetSafeNormal();
-
-	//switch on the interp mode
-	switch (GrappleInterpStruct.InterpMode)
-	{
-		case InterpTo:
-			//interpolate the velocity
-			GrappleVelocity = PlayerCharacter->PlayerMovementComponent->ApplySpeedLimit(FMath::VInterpTo(GetOwner()->GetVelocity(), LocGrappleDirection * GrappleInterpStruct.PullSpeed, DeltaTime, GrappleInterpStruct.PullAccel), DeltaTime);
-			break;
-		case InterpStep:
-			//interpolate the velocity
-			GrappleVelocity = PlayerCharacter->PlayerMovementComponent->ApplySpeedLimit(FMath::VInterpTo(GetOwner()->GetVelocity(), LocGrappleDirection * GrappleInterpStruct.PullSpeed, DeltaTime, GrappleInterpStruct.PullAccel), DeltaTime);
-			break;
+	//storage for the grapple direction (of the current pull step)
+	const FVector LocGrappleDirection = FrameContext.GrappleDirection.GetSafeNormal();
 
-		default /* constant */:
-			//interpolate the velocity
-			GrappleVelocity = PlayerCharacter->PlayerMovementComponent->ApplySpeedLimit(FMath::VInterpConstantTo(GetOwner()->GetVelocity(),  LocGrappleDirection * GrappleInterpStruct.PullSpeed, DeltaTime, GrappleInterpStruct.PullAccel), DeltaTime);
-			break;
-	}
+	//interpolate the velocity (the interpolation is shared with the trajectory preview)
+	GrappleVelocity = PlayerCharacter->PlayerMovementComponent->ApplySpeedLimit(CalculateInterpVelocity(GrappleInterpStruct, GetOwner()->GetVelocity(), LocGrappleDirection, DeltaTime), DeltaTime);
 
 	//check for potential modifiers to the grapple velocity from the grappleable component
 	CheckTargetForceModifiers(GrappleVelocity, DeltaTime);
@@ -450,39 +547,67 @@ void UGrapplingComponent::DoInterpGrapple(float DeltaTime, FVector& GrappleVeloc
 
 void UGrapplingComponent::DoGrappleTrace(float MaxDistance, bool DoSphereTrace)
 {
-	//storage for camera location and rotation
-	FVector CameraLocation;
-	FRotator CameraRotation;
-
-	//set the camera location and rotation
-	GetOwner()->GetNetOwningPlayer()->GetPlayerController(GetWorld())->GetPlayerViewPoint(CameraLocation, CameraRotation);
+	//get the start and end of the trace
+	FVector Start;
+	FVector End;
+	GetGrappleTraceStartEnd(MaxDistance, Start, End);
 
-	//get the forward vector of the camera rotation
-	const FVector Rotation = CameraRotation.Quaternion().GetForwardVector();
-
-	//get the end point of the line trace
-	const FVector End = CameraLocation + Rotation * MaxDistance;
+	//shorten the trace with the baked visibility when we're only doing a line trace (the sphere trace can hit surfaces next to the line)
+	if (!DoSphereTrace)
+	{
+		ApplyBakedVisibility(Start, End);
+	}
 
 	//the collision parameters to use for the line trace
-	const FCollisionQueryParams GrappleCollisionParams = RopeComponent->GetCollisionParams();
-
-	//empty the grapple trace hits
-	GrappleHits.Empty();
+	const FCollisionQueryParams& GrappleCollisionParams = RopeComponent->GetCollisionParams();
 
 	//storage for the temp array
 	TArray<FHitResult> TempArray;
 
 	//do the line trace
-	GetWorld()->LineTraceMultiByChannel(TempArray, CameraLocation, End, RopeComponent->CollisionChannel, GrappleCollisionParams);
+	HILT_COUNT_SCENE_QUERY();
+	GetWorld()->LineTraceMultiByChannel(TempArray, Start, End, RopeComponent->CollisionChannel, GrappleCollisionParams);
 
 	//check if the temp array is empty and we're doing a sphere trace
 	if (TempArray.IsEmpty() && DoSphereTrace)
 	{
 		//do a sphere multi trace
-		GetWorld()->SweepMultiByChannel(TempArray, CameraLocation, End, FQuat::Identity, RopeComponent->CollisionChannel, FCollisionShape::MakeSphere(GrappleSphereRadius), GrappleCollisionParams);
+		HILT_COUNT_SCENE_QUERY();
+		GetWorld()->SweepMultiByChannel(TempArray, Start, End, FQuat::Identity, RopeComponent->CollisionChannel, FCollisionShape::MakeSphere(GrappleSphereRadius), GrappleCollisionParams);
+	}
+
+	//filter the hits into the grapple hits
+	FilterGrappleHits(TempArray, GrappleHits);
+}
+
+void UGrapplingComponent::GetGrappleTraceStartEnd(const float MaxDistance, FVector& OutStart, FVector& OutEnd) const
+{
+	//storage for camera rotation
+	FRotator CameraRotation;
+
+	//set the camera location and rotation from the owner's controller (doesn't need a local player, so it also works in the headless benchmarks)
+	const APawn* OwnerPawn = Cast<APawn>(GetOwner());
+	const AController* Controller = OwnerPawn ? OwnerPawn->GetController() : nullptr;
+	if (!Controller)
+	{
+		//fall back to the owner's eyes
+		GetOwner()->GetActorEyesViewPoint(OutStart, CameraRotation);
+	}
+	else
+	{
+		Controller->GetPlayerViewPoint(OutStart, CameraRotation);
 	}
 
-	for (const FHitResult& GrappleHit : TempArray)
+	//get the end point of the trace along the forward vector of the camera rotation
+	OutEnd = OutStart + CameraRotation.Quaternion().GetForwardVector() * MaxDistance;
+}
+
+void UGrapplingComponent::FilterGrappleHits(const TArray<FHitResult>& Hits, TArray<FHitResult>& OutHits) const
+{
+	//empty the output hits
+	OutHits.Reset();
+
+	for (const FHitResult& GrappleHit : Hits)
 	{
 		//get the distance from the line trace start to the hit location
 		const float Distance = FVector::Dist(GetOwner()->GetActorLocation(), GrappleHit.ImpactPoint);
@@ -494,30 +619,232 @@ void UGrapplingComponent::DoGrappleTrace(float MaxDistance, bool DoSphereTrace)
 		}
 
 		//add the hit to the returned hits
-		GrappleHits.Add(GrappleHit);
+		OutHits.Add(GrappleHit);
 	}
 }
 
-void UGrapplingComponent::CheckTargetForceModifiers(FVector& BaseVel, float DeltaTime) const
+void UGrapplingComponent::ApplyBakedVisibility(const FVector& Start, FVector& End) const
+{
+	//check if we shouldn't use the baked visibility
+	if (!bUseBakedVisibility)
+	{
+		return;
+	}
+
+	//get the grapple visibility subsystem and check if the level has been baked
+	const UGrappleVisibilitySubsystem* VisibilitySubsystem = GetWorld()->GetSubsystem<UGrappleVisibilitySubsystem>();
+	if (!VisibilitySubsystem || !VisibilitySubsystem->HasData())
+	{
+		return;
+	}
+
+	//get the direction and length of the trace
+	const FVector Direction = (End - Start).GetSafeNormal();
+	const float TraceDistance = FVector::Dist(Start, End);
+
+	//get the farthest static surface we could hit along the trace
+	float VisibleDistance = 0;
+	if (!VisibilitySubsystem->GetMaxVisibleDistance(Start, Direction, TraceDistance, VisibleDistance))
+	{
+		return;
+	}
+
+	//check if the bake didn't find static surfaces all around the trace (something can be hit through the gap, use the full trace)
+	if (VisibleDistance <= 0)
+	{
+		return;
+	}
+
+	//shorten the trace to the farthest static surface around it (anything beyond it is behind static geometry in every neighbouring direction)
+	End = Start + Direction * VisibleDistance;
+}
+
+bool UGrapplingComponent::FindAimAssistHit(FHitResult& OutHit) const
+{
+	//get the grapple target subsystem
+	const UGrappleTargetSubsystem* GrappleTargetSubsystem = GetWorld()->GetSubsystem<UGrappleTargetSubsystem>();
+	if (!GrappleTargetSubsystem)
+	{
+		return false;
+	}
+
+	//get the start and end of the grapple trace
+	FVector Start;
+	FVector End;
+	GetGrappleTraceStartEnd(MaxGrappleDistance, Start, End);
+
+	//find the best target in the aim assist cone
+	const UGrappleableComponent* Target = GrappleTargetSubsystem->FindBestTarget(Start, (End - Start).GetSafeNormal(), MaxGrappleDistance, AimAssistAngle, AimAssistAngleWeight, GetOwner());
+	if (!Target)
+	{
+		return false;
+	}
+
+	//get the direction and distance to the target
+	const FVector TargetOffset = Target->GetComponentLocation() - Start;
+	const float TargetDistance = TargetOffset.Size();
+
+	//check if the target is static and the baked visibility says every baked ray towards it stopped in front of it
+	const UGrappleVisibilitySubsystem* VisibilitySubsystem = GetWorld()->GetSubsystem<UGrappleVisibilitySubsystem>();
+	if (float VisibleDistance = 0; bUseBakedVisibility && VisibilitySubsystem && Target->Mobility == EComponentMobility::Static && VisibilitySubsystem->GetMaxVisibleDistance(Start, TargetOffset / TargetDistance, MaxGrappleDistance, VisibleDistance) && VisibleDistance + Target->GetOwner()->GetRootComponent()->Bounds.SphereRadius < TargetDistance)
+	{
+		return false;
+	}
+
+	//do a single line trace through the target to confirm nothing is in the way
+	HILT_COUNT_SCENE_QUERY();
+	GetWorld()->LineTraceSingleByChannel(OutHit, Start, Start + (Target->GetComponentLocation() - Start).GetSafeNormal() * MaxGrappleDistance, RopeComponent->CollisionChannel, RopeComponent->GetCollisionParams());
+
+	//check that we hit the target's actor
+	if (!OutHit.IsValidBlockingHit() || OutHit.GetActor() != Target->GetOwner())
+	{
+		return false;
+	}
+
+	//check that the hit passes the same checks as the grapple trace hits
+	TArray<FHitResult> ConfirmedHits;
+	FilterGrappleHits({ OutHit }, ConfirmedHits);
+	return !ConfirmedHits.IsEmpty();
+}
+
+void UGrapplingComponent::RequestAvailabilityTrace()
+{
+	//get the start and end of the trace
+	FVector Start;
+	FVector End;
+	GetGrappleTraceStartEnd(MaxGrappleDistance, Start, End);
+
+	//shorten the trace with the baked visibility
+	ApplyBakedVisibility(Start, End);
+
+	//start the async multi line trace (the delegate is called once the results are ready next frame)
+	HILT_COUNT_SCENE_QUERY();
+	GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Multi, Start, End, RopeComponent->CollisionChannel, RopeComponent->GetCollisionParams(), FCollisionResponseParams::DefaultResponseParam, &AvailabilityTraceDelegate);
+}
+
+void UGrapplingComponent::OnAvailabilityTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	//filter the hits into the availability hits
+	FilterGrappleHits(TraceDatum.OutHits, AvailabilityHits);
+
+	//store the frame the availability hits are from
+	AvailabilityResultFrame = GFrameCounter;
+
+	//update the can grapple variable
+	CanGrappleVar = !AvailabilityHits.IsEmpty();
+}
+
+bool UGrapplingComponent::GetValidAvailabilityHit(FHitResult& OutHit) const
+{
+	//check if the availability result is empty or too old
+	if (AvailabilityHits.IsEmpty() || GFrameCounter - AvailabilityResultFrame > static_cast<uint64>(MaxAvailabilityResultAge))
+	{
+		return false;
+	}
+
+	//get the first availability hit
+	const FHitResult& Hit = AvailabilityHits[0];
+
+	//check that the hit actor and component still exist
+	if (!IsValid(Hit.GetActor()) || !IsValid(Hit.GetComponent()))
+	{
+		return false;
+	}
+
+	//get the start and end of the grapple trace for where we're aiming now
+	FVector Start;
+	FVector End;
+	GetGrappleTraceStartEnd(MaxGrappleDistance, Start, End);
+
+	//check that the hit is still within grapple range
+	if (FVector::DistSquared(Start, Hit.ImpactPoint) > FMath::Square(MaxGrappleDistance))
+	{
+		return false;
+	}
+
+	//check that the aim hasn't moved too far away from the hit
+	if (FVector::DotProduct((End - Start).GetSafeNormal(), (Hit.ImpactPoint - Start).GetSafeNormal()) < FMath::Cos(FMath::DegreesToRadians(AvailabilityRevalidateAngle)))
+	{
+		return false;
+	}
+
+	//check that the hit still passes the same checks as the grapple trace hits (the player may have moved)
+	TArray<FHitResult> ConfirmedHits;
+	FilterGrappleHits({ Hit }, ConfirmedHits);
+	if (ConfirmedHits.IsEmpty())
+	{
+		return false;
+	}
+
+	//return the hit
+	OutHit = Hit;
+	return true;
+}
+
+void UGrapplingComponent::ApplyFirstPullStep()
+{
+	//check if the grapple didn't start
+	if (!bIsGrappling)
+	{
+		return;
+	}
+
+	//resolve the frame context for the new target (the pull reads its speed limit and rope direction)
+	UpdateFrameContext();
+
+	//assign the grapple direction
+	GrappleDirection = FrameContext.GrappleDirection;
+
+	//apply one fixed pull step now
+	BeginTargetPullSteps();
+	ApplyPullForce(GrappleFixedTimeStep);
+	EndTargetPullSteps();
+
+	//take the step out of the accumulator so the tick doesn't apply it again
+	PullTimeAccumulator -= GrappleFixedTimeStep;
+}
+
+void UGrapplingComponent::CheckTargetForceModifiers(FVector& BaseVel, float DeltaTime)
 {
 	//check if we have a valid grappleable component
 	if (GrappleableComponent->IsValidLowLevelFast())
 	{
-		//apply the grapple velocity to the owner of the grappleable component
-		Cast<UPrimitiveComponent>(GrappleableComponent->GetOwner()->GetRootComponent())->SetAllPhysicsLinearVelocity(FMath::VInterpTo(GrappleableComponent->GetOwner()->GetVelocity(), -GrappleDirection * GrappleableComponent->GrappleInterpStructThis.PullSpeed, DeltaTime, GrappleableComponent->GrappleInterpStructThis.PullAccel), false);
+		//step the grapple velocity of the owner of the grappleable component (applied once the steps are done)
+		TargetPullVelocity = FMath::VInterpTo(TargetPullVelocity, -FrameContext.GrappleDirection * GrappleableComponent->GrappleInterpStructThis.PullSpeed, DeltaTime, GrappleableComponent->GrappleInterpStructThis.PullAccel);
 
 		//apply the grapple velocity to the player
-		BaseVel *= GrappleableComponent->GrappleReelForceMultiplierPlayer;
+		BaseVel *= GrappleableMetadata.ReelForceMultiplierPlayer;
 	}
 }
 
-void UGrapplingComponent::CheckTargetPullSpeedModifiers(float& PullSpeed) const
+void UGrapplingComponent::BeginTargetPullSteps()
+{
+	//start from the current velocity of the owner of the grappleable component
+	TargetPullVelocity = GrappleableComponent->IsValidLowLevelFast() ? GrappleableComponent->GetOwner()->GetVelocity() : FVector::ZeroVector;
+}
+
+void UGrapplingComponent::EndTargetPullSteps() const
 {
 	//check if we have a valid grappleable component
-	if (GrappleableComponent->IsValidLowLevelFast())
+	if (!GrappleableComponent->IsValidLowLevelFast())
+	{
+		return;
+	}
+
+	//apply the stepped grapple velocity to the owner of the grappleable component
+	if (UPrimitiveComponent* TargetRoot = Cast<UPrimitiveComponent>(GrappleableComponent->GetOwner()->GetRootComponent()))
+	{
+		TargetRoot->SetAllPhysicsLinearVelocity(TargetPullVelocity, false);
+	}
+}
+
+void UGrapplingComponent::CheckTargetPullSpeedModifiers(float& PullSpeed) const
+{
+	//check if we have a grappleable component
+	if (GrappleableMetadata.Grappleable)
 	{
 		//apply the grapple velocity to the player
-		PullSpeed *= GrappleableComponent->GrappleReelForceMultiplierPlayer;
+		PullSpeed *= GrappleableMetadata.ReelForceMultiplierPlayer;
 	}
 }
 
@@ -530,9 +857,6 @@ void UGrapplingComponent::ApplyPullForce(float DeltaTime)
 		return;
 	}
 
-	//storage for the velocity that will be applied from the grapple
-	FVector GrappleVelocity = /*RopeComponent->GetRopeDirection(0)*/ GrappleDirection.GetSafeNormal() * GetPullSpeed() * DeltaTime;
-
 	FVector BaseVel;
 
 	//check how we should set the velocity
@@ -540,35 +864,13 @@ void UGrapplingComponent::ApplyPullForce(float DeltaTime)
 	switch (GetGrappleMode())
 	{
 		case AddToVelocity:
-			//check if we have a valid angle curve
-			if (PlayerCharacter->ScoreComponent->GetCurrentScoreValues().GrappleAngleCurve)
-			{
-				//get the grapple angle curve value
-				const float Value = PlayerCharacter->ScoreComponent->GetCurrentScoreValues().GrappleAngleCurve->GetFloatValue(GetGrappleDotProduct(GrappleVelocity.GetSafeNormal()));
+		{
+			//get the simulation params for the current grapple (the pull math is shared with the trajectory preview)
+			FGrappleSimParams SimParams;
+			GetSimParams(FrameContext.PivotLocation, FrameContext.RopeEnd, SimParams);
 
-				//multiply the grapple velocity by the grapple curve value
-				GrappleVelocity *= Value;
-			}
-
-			//check if we have a valid distance curve
-			if (PlayerCharacter->ScoreComponent->GetCurrentScoreValues().GrappleDistanceCurve)
-			{
-				//get the grapple distance curve value
-				const float Value = PlayerCharacter->ScoreComponent->GetCurrentScoreValues().GrappleDistanceCurve->GetFloatValue(FMath::Clamp(FVector::Dist(GetOwner()->GetActorLocation(), RopeComponent->GetRopeEnd()) / MaxGrappleDistance, 0, 1));
-				 
-				//multiply the grapple velocity by the grapple distance curve value
-				GrappleVelocity *= Value;
-			}
-
-			//check if we have a valid GrappleVelocityCurve and GrappleVelocityDotProductCurve
-			if (PlayerCharacter->ScoreComponent->GetCurrentScoreValues().GrappleVelocityCurve)
-			{
-				//get the grapple velocity curve value
-				const float VelocityValue = PlayerCharacter->ScoreComponent->GetCurrentScoreValues().GrappleVelocityCurve->GetFloatValue(PlayerCharacter->PlayerMovementComponent->ApplySpeedLimit(GrappleVelocity, DeltaTime, false).Size() / PlayerCharacter->PlayerMovementComponent->GetCurrentSpeedLimit());
-				
-				//multiply the grapple velocity by the grapple velocity curve value
-				GrappleVelocity *= VelocityValue;
-			}
+			//get the velocity that will be applied from the grapple
+			const FVector GrappleVelocity = CalculatePullImpulse(SimParams, FrameContext.OwnerLocation, PlayerCharacter->PlayerMovementComponent->Velocity, FrameContext.GrappleDirection, DeltaTime);
 
 			//calculate the grapple dot product
 			GrappleDotProduct = GetGrappleDotProduct(GrappleVelocity);
@@ -585,6 +887,7 @@ void UGrapplingComponent::ApplyPullForce(float DeltaTime)
 			PlayerCharacter->PlayerMovementComponent->Velocity = PlayerCharacter->PlayerMovementComponent->ApplySpeedLimit(BaseVel, DeltaTime, false);
 
 		break;
+		}
 		case InterpVelocity:
 			//do the interpolation
 			DoInterpGrapple(DeltaTime, PlayerCharacter->PlayerMovementComponent->Velocity, GetGrappleInterpStruct());
@@ -592,22 +895,300 @@ void UGrapplingComponent::ApplyPullForce(float DeltaTime)
 	}
 }
 
+void UGrapplingComponent::OnScoreTierChanged(int32 NewTier, int32 OldTier)
+{
+	//cache the score values of the new score tier
+	FrameContext.ScoreValues = PlayerCharacter->ScoreComponent->GetScoreValues();
+}
+
+void UGrapplingComponent::UpdateFrameContext()
+{
+	//get the movement component
+	const UPlayerMovementComponent* MovementComponent = PlayerCharacter->PlayerMovementComponent;
+
+	//get the owner's location and velocity
+	FrameContext.OwnerLocation = GetOwner()->GetActorLocation();
+	FrameContext.Velocity = GetOwner()->GetVelocity();
+	FrameContext.VelocityDirection = FrameContext.Velocity.GetSafeNormal();
+
+	//check if we have a rope to read from
+	const bool bHasRope = bIsGrappling && RopeComponent && RopeComponent->RopePoints.Num() >= 2;
+
+	//get the rope values
+	FrameContext.PivotLocation = bHasRope ? RopeComponent->GetSecondRopePoint() : FrameContext.OwnerLocation;
+	FrameContext.RopeEnd = bHasRope ? RopeComponent->GetRopeEnd() : FrameContext.OwnerLocation;
+	FrameContext.GrappleDirection = bHasRope ? RopeComponent->GetRopeDirection() : FVector::ZeroVector;
+	FrameContext.DistanceRatio = FMath::Clamp(FVector::Dist(FrameContext.OwnerLocation, FrameContext.RopeEnd) / FMath::Max(MaxGrappleDistance, 1.f), 0.f, 1.f);
+
+	//get the speed limits (matches UPlayerMovementComponent::ApplySpeedLimit)
+	FrameContext.CurrentSpeedLimit = FMath::Max(MovementComponent->GetCurrentSpeedLimit(), KINDA_SMALL_NUMBER);
+	FrameContext.SpeedLimit = FMath::Min(MovementComponent->GetCurrentSpeedLimit(), MovementComponent->GetMaxSpeed());
+}
+
+void UGrapplingComponent::ApplyFixedStepPullForce(const float DeltaTime)
+{
+	//add the frame time to the accumulator
+	PullTimeAccumulator += DeltaTime;
+
+	//save the frame context values the steps move forward (the rest of the tick reads the ones from the start of the frame)
+	const FVector FrameOwnerLocation = FrameContext.OwnerLocation;
+	const FVector FrameGrappleDirection = FrameContext.GrappleDirection;
+	const float FrameDistanceRatio = FrameContext.DistanceRatio;
+
+	//get the start of the rope (moved along with the owner between steps)
+	const bool bHasRope = RopeComponent && RopeComponent->RopePoints.Num() >= 2;
+	FVector RopeStart = bHasRope ? RopeComponent->RopePoints[0].GetWL() : FrameContext.OwnerLocation;
+
+	//the number of steps applied this frame
+	int32 NumSteps = 0;
+
+	//start stepping the grappled target's velocity
+	BeginTargetPullSteps();
+
+	//apply the pull force for every whole fixed step that passed (the rest is kept for the next frame)
+	while (PullTimeAccumulator >= GrappleFixedTimeStep && NumSteps < MaxGrappleSubsteps)
+	{
+		//apply the pull force for one step
+		ApplyPullForce(GrappleFixedTimeStep);
+
+		//consume the step
+		PullTimeAccumulator -= GrappleFixedTimeStep;
+		++NumSteps;
+
+		//check if we have a rope to point the next step along
+		if (!bHasRope)
+		{
+			continue;
+		}
+
+		//move the owner and the start of the rope to where the step's velocity takes them
+		const FVector StepOffset = PlayerCharacter->PlayerMovementComponent->Velocity * GrappleFixedTimeStep;
+		FrameContext.OwnerLocation += StepOffset;
+		RopeStart += StepOffset;
+
+		//get the rope direction and distance from there (matches UpdateFrameContext)
+		FrameContext.GrappleDirection = (FrameContext.PivotLocation - RopeStart).GetSafeNormal();
+		FrameContext.DistanceRatio = FMath::Clamp(FVector::Dist(FrameContext.OwnerLocation, FrameContext.RopeEnd) / FMath::Max(MaxGrappleDistance, 1.f), 0.f, 1.f);
+	}
+
+	//check if we applied any steps
+	if (NumSteps > 0)
+	{
+		//apply the stepped velocity to the grappled target
+		EndTargetPullSteps();
+	}
+
+	//check if we hit the step limit
+	if (NumSteps == MaxGrappleSubsteps)
+	{
+		//drop the time we couldn't simulate
+		PullTimeAccumulator = FMath::Min(PullTimeAccumulator, GrappleFixedTimeStep);
+	}
+
+	//restore the frame context values
+	FrameContext.OwnerLocation = FrameOwnerLocation;
+	FrameContext.GrappleDirection = FrameGrappleDirection;
+	FrameContext.DistanceRatio = FrameDistanceRatio;
+}
+
+void UGrapplingComponent::UpdateTrajectoryPreview()
+{
+	//check if we're still simulating the last preview
+	if (PreviewTask.IsValid())
+	{
+		//check if the last preview isn't done yet
+		if (!PreviewTask.IsCompleted())
+		{
+			return;
+		}
+
+		//swap the finished path in (swapping keeps both allocations)
+		Swap(PreviewPath, PreviewBackBuffer);
+		PreviewTask = UE::Tasks::TTask<void>();
+	}
+
+	//check if there is nothing to preview
+	if (!bIsGrappling && AvailabilityHits.IsEmpty())
+	{
+		//clear the preview path
+		PreviewPath.Reset();
+		return;
+	}
+
+	//get where the rope would pull us (the current rope or the point we're aiming at)
+	const FVector PivotLocation = bIsGrappling ? RopeComponent->GetSecondRopePoint() : AvailabilityHits[0].ImpactPoint;
+	const FVector RopeEnd = bIsGrappling ? RopeComponent->GetRopeEnd() : AvailabilityHits[0].ImpactPoint;
+
+	//copy everything the simulation needs so the worker thread doesn't touch the components
+	FGrappleSimParams Params;
+	GetSimParams(PivotLocation, RopeEnd, Params);
+	const FGrappleSimState State = { GetOwner()->GetActorLocation(), GetOwner()->GetVelocity() };
+	const int32 NumSteps = PreviewNumSteps;
+	const float TimeStep = PreviewTimeStep;
+
+	//simulate the next preview on a worker thread (only the worker touches the back buffer until the task is done)
+	PreviewTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [this, Params, State, NumSteps, TimeStep]()
+	{
+		SimulateGrapple(Params, State, TimeStep, NumSteps, PreviewBackBuffer);
+	});
+
+	//check if we're using debug mode
+	if (bUseDebugMode)
+	{
+		//draw the current preview path
+		for (int Index = 0; Index < PreviewPath.Num() - 1; ++Index)
+		{
+			DrawDebugLine(GetWorld(), PreviewPath[Index], PreviewPath[Index + 1], FColor::Cyan, false, 0.f, 0, 2.f);
+		}
+	}
+}
+
+void UGrapplingComponent::GetSimParams(const FVector& PivotLocation, const FVector& RopeEnd, FGrappleSimParams& OutParams) const
+{
+	//get the movement component
+	const UPlayerMovementComponent* MovementComponent = PlayerCharacter->PlayerMovementComponent;
+
+	//set the rope values
+	OutParams.PivotLocation = PivotLocation;
+	OutParams.RopeEnd = RopeEnd;
+	OutParams.StopDistance = GrappleStopDistance;
+	OutParams.MaxGrappleDistance = FMath::Max(MaxGrappleDistance, 1.f);
+
+	//set the pull values
+	OutParams.GrappleMode = GetGrappleMode();
+	OutParams.InterpStruct = GetGrappleInterpStruct();
+	OutParams.PullSpeed = GetPullSpeed();
+	OutParams.ReelForceMultiplierPlayer = GrappleableMetadata.Grappleable ? GrappleableMetadata.ReelForceMultiplierPlayer : 1.f;
+
+	//set the movement values
+	OutParams.SpeedLimit = FrameContext.SpeedLimit;
+	OutParams.CurrentSpeedLimit = FrameContext.CurrentSpeedLimit;
+	OutParams.GravityZ = bApplyGravityWhenGrappling ? MovementComponent->GetGravityZ() : 0.f;
+
+	//set the score curves
+	OutParams.AngleCurve = FrameContext.ScoreValues.GrappleAngleCurve ? HiltCurves::FindOrBake(FrameContext.ScoreValues.GrappleAngleCurve) : nullptr;
+	OutParams.DistanceCurve = FrameContext.ScoreValues.GrappleDistanceCurve ? HiltCurves::FindOrBake(FrameContext.ScoreValues.GrappleDistanceCurve) : nullptr;
+	OutParams.VelocityCurve = FrameContext.ScoreValues.GrappleVelocityCurve ? HiltCurves::FindOrBake(FrameContext.ScoreValues.GrappleVelocityCurve) : nullptr;
+}
+
+void UGrapplingComponent::PredictGrapplePath(const FVector TargetLocation, const int32 NumSteps, const float TimeStep, TArray<FVector>& OutPath) const
+{
+	//get the simulation params for the current rope or the target location
+	FGrappleSimParams Params;
+	GetSimParams(bIsGrappling ? RopeComponent->GetSecondRopePoint() : TargetLocation, bIsGrappling ? RopeComponent->GetRopeEnd() : TargetLocation, Params);
+
+	//simulate the grapple from the owner's current state
+	SimulateGrapple(Params, { GetOwner()->GetActorLocation(), GetOwner()->GetVelocity() }, TimeStep, NumSteps, OutPath);
+}
+
+FVector UGrapplingComponent::CalculatePullImpulse(const FGrappleSimParams& Params, const FVector& Location, const FVector& Velocity, const FVector& Direction, const float DeltaTime)
+{
+	//storage for the velocity that will be applied from the grapple
+	FVector GrappleVelocity = Direction * Params.PullSpeed * DeltaTime;
+
+	//check if we have a valid angle curve
+	if (Params.AngleCurve)
+	{
+		//multiply the grapple velocity by the grapple angle curve value
+		GrappleVelocity *= Params.AngleCurve->Evaluate(FVector::DotProduct(Velocity.GetSafeNormal(), GrappleVelocity.GetSafeNormal()));
+	}
+
+	//check if we have a valid distance curve
+	if (Params.DistanceCurve)
+	{
+		//multiply the grapple velocity by the grapple distance curve value
+		GrappleVelocity *= Params.DistanceCurve->Evaluate(FMath::Clamp(FVector::Dist(Location, Params.RopeEnd) / Params.MaxGrappleDistance, 0, 1));
+	}
+
+	//check if we have a valid velocity curve
+	if (Params.VelocityCurve)
+	{
+		//multiply the grapple velocity by the grapple velocity curve value
+		GrappleVelocity *= Params.VelocityCurve->Evaluate(FMath::Min(GrappleVelocity.Size(), Params.SpeedLimit) / Params.CurrentSpeedLimit);
+	}
+
+	return GrappleVelocity;
+}
+
+FVector UGrapplingComponent::CalculateInterpVelocity(const FGrappleInterpStruct& InterpStruct, const FVector& Velocity, const FVector& Direction, const float DeltaTime)
+{
+	//switch on the interp mode
+	switch (InterpStruct.InterpMode)
+	{
+		case InterpTo:
+		case InterpStep:
+			//interpolate the velocity
+			return FMath::VInterpTo(Velocity, Direction * InterpStruct.PullSpeed, DeltaTime, InterpStruct.PullAccel);
+
+		default /* constant */:
+			//interpolate the velocity
+			return FMath::VInterpConstantTo(Velocity, Direction * InterpStruct.PullSpeed, DeltaTime, InterpStruct.PullAccel);
+	}
+}
+
+bool UGrapplingComponent::SimulatePullStep(const FGrappleSimParams& Params, FGrappleSimState& State, const float DeltaTime)
+{
+	//check if we've reached the end of the rope
+	if (FVector::Dist(State.Location, Params.RopeEnd) < Params.StopDistance)
+	{
+		return false;
+	}
+
+	//get the direction the rope pulls in
+	const FVector Direction = (Params.PivotLocation - State.Location).GetSafeNormal();
+
+	//check which grapple mode we're simulating
+	if (Params.GrappleMode == AddToVelocity)
+	{
+		//add the pull to the velocity and apply the grappleable modifier and the speed limit
+		State.Velocity = ((State.Velocity + CalculatePullImpulse(Params, State.Location, State.Velocity, Direction, DeltaTime)) * Params.ReelForceMultiplierPlayer).GetClampedToMaxSize(Params.SpeedLimit);
+	}
+	else
+	{
+		//interpolate the velocity, apply the speed limit and then the grappleable modifier
+		State.Velocity = CalculateInterpVelocity(Params.InterpStruct, State.Velocity, Direction, DeltaTime).GetClampedToMaxSize(Params.SpeedLimit) * Params.ReelForceMultiplierPlayer;
+	}
+
+	//apply gravity
+	State.Velocity.Z += Params.GravityZ * DeltaTime;
+
+	//move the simulated player
+	State.Location += State.Velocity * DeltaTime;
+
+	return true;
+}
+
+void UGrapplingComponent::SimulateGrapple(const FGrappleSimParams& Params, FGrappleSimState State, const float TimeStep, const int32 NumSteps, TArray<FVector>& OutLocations)
+{
+	//reset the locations (keeps the allocation)
+	OutLocations.Reset(NumSteps + 1);
+
+	//add the start location
+	OutLocations.Add(State.Location);
+
+	//simulate the steps until we reach the end of the rope
+	for (int Step = 0; Step < NumSteps && SimulatePullStep(Params, State, TimeStep); ++Step)
+	{
+		OutLocations.Add(State.Location);
+	}
+}
+
 void UGrapplingComponent::OnGrappleTargetDestroyed(AActor* DestroyedActor)
 {
-	//stop grappling
+	//stop grappling (forgets the grappleable component of the destroyed actor)
 	StopGrapple();
 }
 
 FGrappleInterpStruct UGrapplingComponent::GetGrappleInterpStruct() const
 {
-	//check if we have a valid grappleable component
-	if (GrappleableComponent)
+	//check if we have a grappleable component
+	if (GrappleableMetadata.Grappleable)
 	{
 		//check if we should use the grappleable components grapple interp struct
-		if (GrappleableComponent->ShouldUseGrappleInterpStruct())
+		if (GrappleableMetadata.bUseGrappleInterpStruct)
 		{
 			//return the objective grapple interp struct
-			return GrappleableComponent->GetGrappleInterpStruct();
+			return GrappleableMetadata.InterpStructPlayer;
 		}
 	}
 
@@ -618,7 +1199,7 @@ FGrappleInterpStruct UGrapplingComponent::GetGrappleInterpStruct() const
 float UGrapplingComponent::GetPullSpeed() const
 {
 	//return variable
-	float ReturnSpeed = GetGrappleInterpStruct().PullSpeed * PlayerCharacter->ScoreComponent->GetCurrentScoreValues().GrappleSpeedMultiplier;
+	float ReturnSpeed = GetGrappleInterpStruct().PullSpeed * FrameContext.ScoreValues.GrappleSpeedMultiplier;
 
 	//check for pull speed modifiers from the grappleable component
 	CheckTargetPullSpeedModifiers(ReturnSpeed);
@@ -693,11 +1274,11 @@ float UGrapplingComponent::GetRemainingGrappleDistance()
 
 void UGrapplingComponent::SetGrappleMode(const TEnumAsByte<EGrapplingMode> NewGrappleMode)
 {
-	//check if we have a valid grappleable component
-	if (GrappleableComponent)
+	//check if we have a grappleable component
+	if (GrappleableMetadata.Grappleable)
 	{
 		//check if we can't change the grapple mode
-		if (!GrappleableComponent->CanChangeGrappleMode())
+		if (!GrappleableMetadata.bCanChangeGrappleMode)
 		{
 			//prevent changing the grapple mode
 			return;
@@ -3,9 +3,24 @@
 #include "NiagaraFunctionLibrary.h"
 #include "NiagaraSystem.h"
 //#include "math.h"
+#include "Components/GrapplingHook/GrappleTargetSubsystem.h"
+#include "Core/HiltProfiling.h"
+#include "Core/Math/BakedCurve.h"
 #include "Core/HiltTags.h"
+#include "EngineUtils.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetSerialization.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Net/UnrealNetwork.h"
 #include "NPC/Components/GrappleableComponent.h"
 #include "Player/PlayerCharacter.h"
+#include "Player/PlayerRewindBuffer.h"
+
+namespace
+{
+	//whether or not the server logs the bandwidth used by the replicated rope pivots
+	TAutoConsoleVariable<bool> CVarLogRopeNetBandwidth(TEXT("Hilt.Rope.LogNetBandwidth"), false, TEXT("Logs the bytes per second the server writes for each grappling rope's replicated pivots"));
+}
 
 FVerletConstraint::FVerletConstraint()
 {
@@ -117,8 +132,8 @@ void FRopePoint::SetWL(const FVector& NewLocation)
 {
 	//todo add force so that the rope can pull an attached actor
 
-	//check if we're using world location
-	if (bUseWorldSpace)
+	//check if we're using world location (and the point isn't pinned in place)
+	if (IsSimulated())
 	{
 		//set the relative location
 		Location = NewLocation;
@@ -146,17 +161,135 @@ FRopePoint::FRopePoint(AActor* InOtherActor, const FVector& InLocation)
 	Location = InOtherActor->GetTransform().InverseTransformPosition(InLocation);
 }
 
+bool FRopeNetPivot::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	//default to success
+	bOutSuccess = true;
+
+	//serialize the pivot index and flags
+	Ar << PivotIndex;
+	Ar << Flags;
+
+	//check if the pivot is attached to an actor
+	if ((Flags & WorldLocation) == 0)
+	{
+		//serialize the attached actor
+		UObject* Object = AttachedActor;
+		bOutSuccess &= Map->SerializeObject(Ar, AActor::StaticClass(), Object);
+		AttachedActor = Cast<AActor>(Object);
+	}
+	else if (Ar.IsLoading())
+	{
+		//clear the attached actor
+		AttachedActor = nullptr;
+	}
+
+	//serialize the location quantised to a tenth of a unit (24 bits per component fits world locations up to about 8 km from the origin)
+	bOutSuccess &= SerializePackedVector<10, 24>(Location, Ar);
+
+	return true;
+}
+
+void FRopeNetPivot::PostReplicatedAdd(const FRopeNetState& InArraySerializer)
+{
+	InArraySerializer.bPivotsDirty = true;
+}
+
+void FRopeNetPivot::PostReplicatedChange(const FRopeNetState& InArraySerializer)
+{
+	InArraySerializer.bPivotsDirty = true;
+}
+
+void FRopeNetPivot::PreReplicatedRemove(const FRopeNetState& InArraySerializer)
+{
+	InArraySerializer.bPivotsDirty = true;
+}
+
+void FRopeRenderTickFunction::ExecuteTick(const float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	//check if the target is still valid and is ticking (or is stepped by the fixed-step simulation with its tick disabled)
+	if (IsValid(Target) && !Target->IsBeingDestroyed() && (Target->IsComponentTickEnabled() || Target->bSteppedBySimulation))
+	{
+		//render the rope
+		Target->TickRender(DeltaTime);
+	}
+}
+
+FString FRopeRenderTickFunction::DiagnosticMessage()
+{
+	return (Target ? Target->GetFullName() : TEXT("None")) + TEXT("[RenderTick]");
+}
+
+FName FRopeRenderTickFunction::DiagnosticContext(bool bDetailed)
+{
+	return FName(TEXT("RopeRenderTick"));
+}
+
+void FRopeSnapshotHistory::SetCapacity(const int32 NewCapacity)
+{
+	//resize the slots (existing slots keep their allocations)
+	Snapshots.SetNum(FMath::Max(NewCapacity, 0));
+
+	//clear the buffer
+	Reset();
+}
+
+void FRopeSnapshotHistory::Reset()
+{
+	Head = 0;
+	Count = 0;
+}
+
+FRopeSnapshot& FRopeSnapshotHistory::Push()
+{
+	//assert that we have slots to write to
+	check(Snapshots.Num() > 0);
+
+	//get the slot to write to
+	FRopeSnapshot& Slot = Snapshots[Head];
+
+	//advance the head (wrapping around to overwrite the oldest snapshot)
+	Head = (Head + 1) % Snapshots.Num();
+
+	//update the number of valid snapshots
+	Count = FMath::Min(Count + 1, Snapshots.Num());
+
+	return Slot;
+}
+
+const FRopeSnapshot* FRopeSnapshotHistory::GetFromNewest(const int32 Offset) const
+{
+	//check if the offset is out of range
+	if (Offset < 0 || Offset >= Count)
+	{
+		return nullptr;
+	}
+
+	//get the index of the snapshot (the newest snapshot is right behind the head)
+	const int32 Index = (Head - 1 - Offset + Snapshots.Num()) % Snapshots.Num();
+
+	return &Snapshots[Index];
+}
+
 URopeComponent::URopeComponent()
 {
 	//add the no grapple tag
 	ComponentTags.Add(HiltTags::NoGrappleTag);
 
-	////set the tick group and behavior
-	//TickGroup = TG_PostUpdateWork;
+	//simulate the rope in the same tick group as the character movement (the movement is added as a prerequisite in begin play)
+	PrimaryComponentTick.TickGroup = TG_PrePhysics;
 
 	PrimaryComponentTick.bCanEverTick = true;
 	bAutoActivate = true;
 	UActorComponent::SetComponentTickEnabled(true);
+
+	//render the rope after everything else has moved this frame (but before the niagara components tick)
+	RenderTickFunction.bCanEverTick = true;
+	RenderTickFunction.bStartWithTickEnabled = true;
+	RenderTickFunction.TickGroup = TG_PostUpdateWork;
+
+	//replicate the rope pivots
+	SetIsReplicatedByDefault(true);
 }
 
 void URopeComponent::BeginPlay()
@@ -170,28 +303,139 @@ void URopeComponent::BeginPlay()
 		//set the player character
 		PlayerCharacter = LocPlayerCharacter;
 	}
+
+	//check if the owner is a character
+	if (const ACharacter* Character = Cast<ACharacter>(GetOwner()))
+	{
+		//simulate the rope after the character has moved so it doesn't read last frame's position
+		AddTickPrerequisiteComponent(Character->GetCharacterMovement());
+	}
+
+	//allocate the snapshot history slots
+	SnapshotHistory.SetCapacity(SnapshotHistoryLength);
+
+	//get the grapple target subsystem for the grappleable lookups
+	GrappleTargetSubsystem = GetWorld()->GetSubsystem<UGrappleTargetSubsystem>();
+
+	//listen for actors being spawned so new actors of the ignored classes are ignored too
+	ActorSpawnedHandle = GetWorld()->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &URopeComponent::OnActorSpawned));
+
+	//find the actors to ignore and build the collision query params
+	RebuildIgnoredActors();
+
+	//bake the constraint compensation curves
+	HiltCurves::BakeReferencedCurves(this);
+}
+
+void URopeComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	//stop listening for actors being spawned
+	if (GetWorld())
+	{
+		GetWorld()->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+	}
+
+	//call the parent implementation
+	Super::EndPlay(EndPlayReason);
+}
+
+#if WITH_EDITOR
+void URopeComponent::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	//call the parent implementation
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	//check if the ignored classes changed while playing
+	if (PropertyChangedEvent.GetMemberPropertyName() == GET_MEMBER_NAME_CHECKED(URopeComponent, IgnoredClasses) && HasBegunPlay())
+	{
+		//find the actors of the new ignored classes
+		RebuildIgnoredActors();
+	}
 }
+#endif
 
 void URopeComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
 	//call the parent implementation
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
+	//check if we're a simulated proxy that received new pivots from the server
+	if (ShouldUseNetState() && NetState.bPivotsDirty)
+	{
+		//rebuild the rope from the replicated pivots
+		ApplyNetState();
+	}
+
 	//check if we're grappling
 	if (bIsRopeActive)
 	{
-		//update the rope points
-		CheckCollisionPoints();
+		//check if the rope isn't driven by the server's pivots
+		if (!ShouldUseNetState())
+		{
+			//update the rope points
+			CheckCollisionPoints();
+		}
 
-		//render the rope
-		RenderRope();
+		//check if we should update the replicated rope state
+		if (ShouldReplicateNetState())
+		{
+			//update the replicated pivots
+			UpdateNetState();
+
+			//check if we should log the bandwidth
+			if (CVarLogRopeNetBandwidth.GetValueOnGameThread())
+			{
+				LogNetBandwidth();
+			}
+		}
 
+		//check if we're using verlet integration (rendering happens in the render tick, after the simulation)
 		if (bUseVerletIntegration)
 		{
 			//perform the verlet integration
 			VerletIntegration(DeltaTime);
 		}
 	}
+
+	//check if we're recording the snapshot history
+	if (SnapshotHistory.GetCapacity() > 0)
+	{
+		//save this frame's state into the next history slot
+		SaveSnapshot(SnapshotHistory.Push());
+	}
+}
+
+void URopeComponent::RegisterComponentTickFunctions(const bool bRegister)
+{
+	//call the parent implementation
+	Super::RegisterComponentTickFunctions(bRegister);
+
+	//check if we're registering the tick functions
+	if (bRegister)
+	{
+		//register the render tick function
+		if (SetupActorComponentTickFunction(&RenderTickFunction))
+		{
+			//set the target and make sure the rope is simulated before it's rendered
+			RenderTickFunction.Target = this;
+			RenderTickFunction.AddPrerequisite(this, PrimaryComponentTick);
+		}
+	}
+	else if (RenderTickFunction.IsTickFunctionRegistered())
+	{
+		//unregister the render tick function
+		RenderTickFunction.UnRegisterTickFunction();
+	}
+}
+
+void URopeComponent::TickRender(float DeltaTime)
+{
+	//check if the rope is active
+	if (bIsRopeActive)
+	{
+		//render the rope
+		RenderRope();
+	}
 }
 
 void URopeComponent::DestroyComponent(const bool bPromoteChildren)
@@ -206,6 +450,15 @@ void URopeComponent::DestroyComponent(const bool bPromoteChildren)
 	Super::DestroyComponent(bPromoteChildren);
 }
 
+void URopeComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	//call the parent implementation
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	//replicate the rope pivots
+	DOREPLIFETIME(URopeComponent, NetState);
+}
+
 void URopeComponent::EnforceConstraints()
 {
 	//do a number of iterations to enforce the constraints
@@ -258,12 +511,13 @@ void URopeComponent::EnforceConstraints()
 bool URopeComponent::CheckForCollisions(const FVector& Start, const FVector& End, FRopePoint& Point) const
 {
 	//get the collision parameters
-	const FCollisionQueryParams CollisionParams = GetCollisionParams();
+	const FCollisionQueryParams& CollisionParams = GetCollisionParams();
 
 	//storage for line trace hit result
 	FHitResult Hit;
 
 	//do a line trace from the old position to the new position
+	HILT_COUNT_SCENE_QUERY();
 	GetWorld()->LineTraceSingleByChannel(Hit, Start, End, CollisionChannel, CollisionParams);
 
 	//check if we hit something
@@ -295,7 +549,7 @@ bool URopeComponent::CheckForCollisions(const FVector& Start, const FVector& End
 bool URopeComponent::CheckForCollisions(const FVerletConstraint& Constraint, const FVector& InNewStartPos1, const FVector& InNewStartPos2) const
 {
 	//get the collision parameters
-	const FCollisionQueryParams CollisionParams = GetCollisionParams();
+	const FCollisionQueryParams& CollisionParams = GetCollisionParams();
 
 	//get the first and second points of the constraint
 	FRopePoint* StartPoint = Constraint.StartPoint;
@@ -313,7 +567,7 @@ bool URopeComponent::CheckForCollisions(const FVerletConstraint& Constraint, con
 bool URopeComponent::CheckForCollisions(FRopePoint& Point, const FVector& InNewPosition, const FVector& OldPosition, const FVector& InVelocity, const FVector& InAcceleration) const
 {
 	//get the collision parameters
-	const FCollisionQueryParams CollisionParams = GetCollisionParams();
+	const FCollisionQueryParams& CollisionParams = GetCollisionParams();
 
 	//storage for line/sweep trace hit result
 	FHitResult Hit;
@@ -323,6 +577,7 @@ bool URopeComponent::CheckForCollisions(FRopePoint& Point, const FVector& InNewP
 	Shape.SetSphere(RopeRadius);
 
 	//do a line trace from the old position to the new position
+	HILT_COUNT_SCENE_QUERY();
 	GetWorld()->LineTraceSingleByChannel(Hit, InNewPosition, OldPosition, CollisionChannel, CollisionParams);
 	//GetWorld()->SweepSingleByChannel(Hit, InNewPosition, OldPosition, FQuat(), CollisionChannel, Shape, CollisionParams);
 
@@ -453,32 +708,130 @@ void URopeComponent::SetNiagaraSystem(UNiagaraSystem* NewSystem)
 	}
 }
 
-FCollisionQueryParams URopeComponent::GetCollisionParams() const
+const FCollisionQueryParams& URopeComponent::GetCollisionParams() const
+{
+	return CachedCollisionParams;
+}
+
+void URopeComponent::SetIgnoredClasses(const TArray<TSubclassOf<AActor>>& NewIgnoredClasses)
+{
+	//set the ignored classes
+	IgnoredClasses = NewIgnoredClasses;
+
+	//find the actors of the new ignored classes
+	RebuildIgnoredActors();
+}
+
+UGrappleableComponent* URopeComponent::FindGrappleable(const FHitResult& Hit) const
+{
+	//check if we have the grapple target subsystem
+	if (GrappleTargetSubsystem)
+	{
+		//get the registered grappleable component of the hit actor
+		return GrappleTargetSubsystem->FindGrappleable(Hit);
+	}
+
+	//fall back to searching the hit actor's components
+	return Hit.GetActor() ? Hit.GetActor()->FindComponentByClass<UGrappleableComponent>() : nullptr;
+}
+
+bool URopeComponent::IsIgnoredClass(const AActor* Actor) const
+{
+	//iterate through the ignored classes
+	for (const TSubclassOf<AActor>& IgnoredClass : IgnoredClasses)
+	{
+		//check if the actor is of this class
+		if (IgnoredClass && Actor->IsA(IgnoredClass))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void URopeComponent::RebuildIgnoredActors()
+{
+	//stop listening for the old ignored actors being destroyed
+	for (AActor* IgnoredActor : IgnoredActors)
+	{
+		if (IsValid(IgnoredActor))
+		{
+			IgnoredActor->OnDestroyed.RemoveDynamic(this, &URopeComponent::OnIgnoredActorDestroyed);
+		}
+	}
+
+	//clear the ignored actors
+	IgnoredActors.Reset();
+
+	//check if we have a world and classes to ignore
+	if (GetWorld() && !IgnoredClasses.IsEmpty())
+	{
+		//iterate through the ignored classes
+		for (const TSubclassOf<AActor>& IgnoredClass : IgnoredClasses)
+		{
+			//check if the class is set
+			if (!IgnoredClass)
+			{
+				continue;
+			}
+
+			//iterate through the actors of this class
+			for (TActorIterator<AActor> It(GetWorld(), IgnoredClass); It; ++It)
+			{
+				//add the actor to the ignored actors and listen for it being destroyed
+				IgnoredActors.Add(*It);
+				It->OnDestroyed.AddUniqueDynamic(this, &URopeComponent::OnIgnoredActorDestroyed);
+			}
+		}
+	}
+
+	//rebuild the collision query params
+	RebuildCollisionParams();
+}
+
+void URopeComponent::RebuildCollisionParams()
 {
 	//setup collision parameters for traces and sweeps
-	FCollisionQueryParams CollisionParams;
-	CollisionParams.AddIgnoredActor(GetOwner());
+	CachedCollisionParams = FCollisionQueryParams(SCENE_QUERY_STAT(RopeTrace), false, GetOwner());
 
-	////iterate throught the array of ignored classes
-	//for (const TSubclassOf<AActor> IgnoredClass : IgnoredClasses)
-	//{
-	//	//setup an array of the actors to ignore
-	//	TArray<AActor*> IgnoredActors;
+	//add the ignored actors
+	for (const AActor* IgnoredActor : IgnoredActors)
+	{
+		CachedCollisionParams.AddIgnoredActor(IgnoredActor);
+	}
+}
+
+void URopeComponent::OnActorSpawned(AActor* SpawnedActor)
+{
+	//check if the spawned actor should be ignored
+	if (!SpawnedActor || !IsIgnoredClass(SpawnedActor))
+	{
+		return;
+	}
 
-	//	//get the actors of this class
-	//	UGameplayStatics::GetAllActorsOfClass(GetWorld(), IgnoredClass, IgnoredActors);
+	//add the actor to the ignored actors and listen for it being destroyed
+	IgnoredActors.Add(SpawnedActor);
+	SpawnedActor->OnDestroyed.AddUniqueDynamic(this, &URopeComponent::OnIgnoredActorDestroyed);
 
-	//	//add the ignored actors to the collision parameters' ignored actors
-	//	CollisionParams.AddIgnoredActors(IgnoredActors);
-	//}
+	//add the actor to the collision query params (no rebuild needed)
+	CachedCollisionParams.AddIgnoredActor(SpawnedActor);
+}
 
-	return CollisionParams;
+void URopeComponent::OnIgnoredActorDestroyed(AActor* DestroyedActor)
+{
+	//remove the actor from the ignored actors
+	if (IgnoredActors.Remove(DestroyedActor) > 0)
+	{
+		//rebuild the collision query params so they don't keep growing
+		RebuildCollisionParams();
+	}
 }
 
 void URopeComponent::CheckCollisionPoints()
 {
 	//get the collision parameters
-	const FCollisionQueryParams CollisionParams = GetCollisionParams();
+	const FCollisionQueryParams& CollisionParams = GetCollisionParams();
 
 	//iterate through all the rope points
 	for (int Index = 0; Index < RopePoints.Num() - 1; Index++)
@@ -489,6 +842,7 @@ void URopeComponent::CheckCollisionPoints()
 			//sweep from the previous rope point to the next rope point
 			FHitResult Surrounding;
 			//GetWorld()->SweepSingleByChannel(Surrounding, RopePoints[Index - 1].GetWL(), RopePoints[Index + 1].GetWL(), FQuat(), ECC_Visibility, FCollisionShape::MakeSphere(RopeRadius), CollisionParams);
+			HILT_COUNT_SCENE_QUERY();
 			GetWorld()->LineTraceSingleByChannel(Surrounding, RopePoints[Index - 1].GetWL(), RopePoints[Index + 1].GetWL(), CollisionChannel, CollisionParams);
 			//DrawDebugLine(GetWorld(), RopePoints[Index - 1].GetWL(), RopePoints[Index + 1].GetWL(), FColor::Blue, false, 0.f, 0, 5.f);
 
@@ -524,6 +878,7 @@ void URopeComponent::CheckCollisionPoints()
 
 			//sweep from the current rope point to the next rope point
 			//GetWorld()->SweepSingleByChannel(Next, RopePoints[Index].GetWL(), RopePoints[Index + 1].GetWL(), FQuat(), CollisionChannel, FCollisionShape::MakeSphere(RopeRadius), CollisionParams);
+			HILT_COUNT_SCENE_QUERY();
 			GetWorld()->LineTraceSingleByChannel(Next, RopePoints[Index].GetWL(), RopePoints[Index + 1].GetWL(), CollisionChannel, CollisionParams);
 
 
@@ -536,15 +891,11 @@ void URopeComponent::CheckCollisionPoints()
 					////insert the new rope point at the hit location
 					//RopePoints.Insert(Next.Location + Next.ImpactNormal * 10, Index + 1);
 
-					//check if the hit actor has a grappleable component
-					if (Next.GetActor()->FindComponentByClass<UGrappleableComponent>())
+					//get the grappleable component of the hit actor and check if it's valid
+					if (UGrappleableComponent* LocGrappleableComponent = FindGrappleable(Next))
 					{
-						//get the grappleable component and check if it's valid
-						if (UGrappleableComponent* LocGrappleableComponent = Next.GetActor()->FindComponentByClass<UGrappleableComponent>())
-						{
-							//broadcast the collision grapple event
-							LocGrappleableComponent->OnCollisionGrapple(GetOwner(), Next);
-						}
+						//broadcast the collision grapple event
+						LocGrappleableComponent->OnCollisionGrapple(GetOwner(), Next);
 					}
 
 					//insert the new rope point at the correct tarray index
@@ -652,68 +1003,579 @@ void URopeComponent::DeactivateRope()
 		//clear the constraints array
 		Constraints.Empty();
 	}
+
+	//check if we should update the replicated rope state
+	if (ShouldReplicateNetState())
+	{
+		//clear the replicated pivots
+		NetState.Pivots.Reset();
+		NetState.MarkArrayDirty();
+	}
 }
 
 // ReSharper disable once CppParameterMayBeConstPtrOrRef (non-const reference is required for the OtherActor parameter)
 void URopeComponent::ActivateRope(const FHitResult& HitResult)
 {
 	//set the grappleable component
-	this->GrappleableComponent = HitResult.GetActor()->FindComponentByClass<UGrappleableComponent>();
+	this->GrappleableComponent = FindGrappleable(HitResult);
 
 	//set the active state to true
 	bIsRopeActive = true;
 
 	//set the rope points
 	RopePoints = { FRopePoint(GetOwner(), GetComponentLocation()), FRopePoint(HitResult) };
-	RopePoints[0].Component = PlayerCharacter->GetMesh();
+	RopePoints[0].Component = PlayerCharacter ? PlayerCharacter->GetMesh() : nullptr;
 
-	//get the direction from the first rope point to the second rope point
-	const FVector Direction = RopePoints[1].GetWL() - RopePoints[0].GetWL();
+	//check if we're using verlet integration
+	if (bUseVerletIntegration)
+	{
+		//add the verlet points between the two rope points
+		AddVerletPoints();
+	}
+
+	////set the old locations of the rope points
+	//SetRopeOldLocations(GetWorld()->GetDeltaSeconds());
+}
+
+void URopeComponent::AddVerletPoints()
+{
+	//get the direction from the first rope point to the last rope point
+	const FVector Direction = RopePoints.Last().GetWL() - RopePoints[0].GetWL();
+
+	//add the extra verlet points
+	for (int Index = 0; Index < NumVerletPoints - 1; ++Index)
+	{
+		//get how far along the rope the verlet point should be
+		const float Alpha = float(Index + 1) / float(NumVerletPoints + 1);
+
+		//the position of the rope point interpolated between the two rope points
+		const FVector Position = RopePoints[0].GetWL() + Direction * Alpha;
+
+		//add the verlet point to the rope
+		RopePoints.Insert(FRopePoint(Position), RopePoints.Num() - 1);
+
+		////draw a debug sphere at the position of the verlet point
+		//DrawDebugSphere(GetWorld(), Position, 5, 6, FColor::Red, false, 5.f, 0, 5.f);
+	}
+
+	//get the distance between of the constraint
+	const float Dist = Direction.Size() / (NumVerletPoints + 1) * (1 - Stiffness);
+
+	//get the number of constraints to add
+	const int32 NumNewConstraints = RopePoints.Num() - 1;
+
+	//get how far along the rope each constraint is
+	TArray<float, TInlineAllocator<32>> Alphas;
+	Alphas.SetNumUninitialized(NumNewConstraints);
+	for (int Index = 0; Index < NumNewConstraints; ++Index)
+	{
+		Alphas[Index] = float(Index + 1) / float(NumVerletPoints + 1);
+	}
+
+	//evaluate both constraint compensation curves for all the constraints at once
+	TArray<float, TInlineAllocator<32>> Compensations1;
+	TArray<float, TInlineAllocator<32>> Compensations2;
+	Compensations1.SetNumUninitialized(NumNewConstraints);
+	Compensations2.SetNumUninitialized(NumNewConstraints);
+	HiltCurves::FindOrBake(ConstraintCompensation1Curve)->EvaluateBatch(Alphas, Compensations1);
+	HiltCurves::FindOrBake(ConstraintCompensation2Curve)->EvaluateBatch(Alphas, Compensations2);
+
+	//add the constraints
+	for (int Index = 0; Index < NumNewConstraints; ++Index)
+	{
+		//add the constraint to the rope
+		Constraints.Add(FVerletConstraint(&RopePoints[Index], &RopePoints[Index + 1], Compensations1[Index], Compensations2[Index], Dist));
+
+		////draw a debug sphere in the middle of the constraint
+		//DrawDebugSphere(GetWorld(), RopePoints[Index].GetWL() + Direction * Alphas[Index] / 2, Dist / 2, 6, FColor::Green, false, 5.f, 0, 5.f);
+	}
+}
+
+void URopeComponent::SaveSnapshot(FRopeSnapshot& OutSnapshot) const
+{
+	//get the number of rope points and constraints
+	const int32 NumPoints = RopePoints.Num();
+	const int32 NumConstraints = Constraints.Num();
+
+	//set the header values
+	OutSnapshot.Version = FRopeSnapshot::CurrentVersion;
+	OutSnapshot.bIsRopeActive = bIsRopeActive;
+	OutSnapshot.GrappleableComponent = GrappleableComponent;
+
+	//reset the point arrays (keeps their allocations if they're big enough)
+	OutSnapshot.Locations.Reset(NumPoints);
+	OutSnapshot.Velocities.Reset(NumPoints);
+	OutSnapshot.Accelerations.Reset(NumPoints);
+	OutSnapshot.AttachedActors.Reset(NumPoints);
+	OutSnapshot.Components.Reset(NumPoints);
+	OutSnapshot.PointFlags.Reset(NumPoints);
+
+	//iterate through all the rope points
+	for (const FRopePoint& RopePoint : RopePoints)
+	{
+		//pack the rope point
+		OutSnapshot.Locations.Add(RopePoint.Location);
+		OutSnapshot.Velocities.Add(RopePoint.Velocity);
+		OutSnapshot.Accelerations.Add(RopePoint.Acceleration);
+		OutSnapshot.AttachedActors.Add(RopePoint.AttachedActor);
+		OutSnapshot.Components.Add(RopePoint.Component);
+		OutSnapshot.PointFlags.Add(uint8((RopePoint.bIsCollisionPoint ? FRopeSnapshot::CollisionPoint : 0) | (RopePoint.bUseWorldSpace ? FRopeSnapshot::WorldSpace : 0) | (RopePoint.bIsPinned ? FRopeSnapshot::Pinned : 0)));
+	}
+
+	//reset the constraint arrays
+	OutSnapshot.ConstraintStartIndices.Reset(NumConstraints);
+	OutSnapshot.ConstraintEndIndices.Reset(NumConstraints);
+	OutSnapshot.ConstraintCompensations1.Reset(NumConstraints);
+	OutSnapshot.ConstraintCompensations2.Reset(NumConstraints);
+	OutSnapshot.ConstraintDistances.Reset(NumConstraints);
+
+	//iterate through all the constraints
+	for (const FVerletConstraint& Constraint : Constraints)
+	{
+		//convert the constraint's point pointers to indices in the rope points array (INDEX_NONE if they don't point into it)
+		const int32 StartIndex = Constraint.StartPoint ? int32(Constraint.StartPoint - RopePoints.GetData()) : INDEX_NONE;
+		const int32 EndIndex = Constraint.EndPoint ? int32(Constraint.EndPoint - RopePoints.GetData()) : INDEX_NONE;
+
+		//pack the constraint
+		OutSnapshot.ConstraintStartIndices.Add(RopePoints.IsValidIndex(StartIndex) ? StartIndex : INDEX_NONE);
+		OutSnapshot.ConstraintEndIndices.Add(RopePoints.IsValidIndex(EndIndex) ? EndIndex : INDEX_NONE);
+		OutSnapshot.ConstraintCompensations1.Add(Constraint.Compensation1);
+		OutSnapshot.ConstraintCompensations2.Add(Constraint.Compensation2);
+		OutSnapshot.ConstraintDistances.Add(Constraint.Distance);
+	}
+}
+
+bool URopeComponent::RestoreSnapshot(const FRopeSnapshot& Snapshot)
+{
+	//check if the snapshot was saved with a different layout
+	if (!Snapshot.IsValid())
+	{
+		//print a warning message
+		UE_LOG(LogTemp, Warning, TEXT("Tried to restore a rope snapshot with version %d (expected %d)"), Snapshot.Version, FRopeSnapshot::CurrentVersion);
+
+		return false;
+	}
+
+	//check if the snapshot's arrays don't line up (restoring it would index out of bounds)
+	if (!Snapshot.HasMatchingLengths())
+	{
+		//print a warning message
+		UE_LOG(LogTemp, Warning, TEXT("Tried to restore a rope snapshot with mismatched array lengths (%d locations, %d constraint start indices)"), Snapshot.NumPoints(), Snapshot.ConstraintStartIndices.Num());
+
+		return false;
+	}
+
+	//get the number of rope points and constraints
+	const int32 NumPoints = Snapshot.NumPoints();
+	const int32 NumConstraints = Snapshot.ConstraintStartIndices.Num();
+
+	//restore the header values
+	bIsRopeActive = Snapshot.bIsRopeActive;
+	GrappleableComponent = Snapshot.GrappleableComponent;
+
+	//clear the collision points (they point into the rope points array and are rebuilt every verlet step)
+	CollisionPoints.Reset();
+
+	//reset the rope points (keeps the allocation if it's big enough) and add the default points
+	RopePoints.Reset(NumPoints);
+	RopePoints.AddDefaulted(NumPoints);
+
+	//iterate through all the packed rope points
+	for (int Index = 0; Index < NumPoints; ++Index)
+	{
+		//unpack the rope point
+		FRopePoint& RopePoint = RopePoints[Index];
+		RopePoint.Location = Snapshot.Locations[Index];
+		RopePoint.Velocity = Snapshot.Velocities[Index];
+		RopePoint.Acceleration = Snapshot.Accelerations[Index];
+		RopePoint.AttachedActor = Snapshot.AttachedActors[Index];
+		RopePoint.Component = Snapshot.Components[Index];
+		RopePoint.bIsCollisionPoint = (Snapshot.PointFlags[Index] & FRopeSnapshot::CollisionPoint) != 0;
+		RopePoint.bUseWorldSpace = (Snapshot.PointFlags[Index] & FRopeSnapshot::WorldSpace) != 0;
+		RopePoint.bIsPinned = (Snapshot.PointFlags[Index] & FRopeSnapshot::Pinned) != 0;
+	}
+
+	//reset the constraints
+	Constraints.Reset(NumConstraints);
+
+	//iterate through all the packed constraints
+	for (int Index = 0; Index < NumConstraints; ++Index)
+	{
+		//get the indices of the constraint's points
+		const int32 StartIndex = Snapshot.ConstraintStartIndices[Index];
+		const int32 EndIndex = Snapshot.ConstraintEndIndices[Index];
+
+		//add the constraint (pointing into the restored rope points array)
+		Constraints.Add(FVerletConstraint(RopePoints.IsValidIndex(StartIndex) ? &RopePoints[StartIndex] : nullptr, RopePoints.IsValidIndex(EndIndex) ? &RopePoints[EndIndex] : nullptr, Snapshot.ConstraintCompensations1[Index], Snapshot.ConstraintCompensations2[Index], Snapshot.ConstraintDistances[Index]));
+	}
+
+	//remove the niagara components we don't need anymore (one per rope segment, missing ones are spawned when rendering)
+	TrimNiagaraComponents(bIsRopeActive ? NumPoints - 1 : 0);
+
+	return true;
+}
+
+bool URopeComponent::RestoreSnapshotFromHistory(const int32 FramesAgo)
+{
+	//get the snapshot from the history
+	const FRopeSnapshot* Snapshot = SnapshotHistory.GetFromNewest(FramesAgo);
+
+	//check if we don't have a snapshot that far back
+	if (!Snapshot)
+	{
+		return false;
+	}
+
+	//restore the snapshot
+	return RestoreSnapshot(*Snapshot);
+}
+
+int32 URopeComponent::GetNumRewindPivots() const
+{
+	//count the rope points that aren't simulated verlet points
+	int32 NumPivots = 0;
+	for (const FRopePoint& RopePoint : RopePoints)
+	{
+		NumPivots += RopePoint.IsSimulated() ? 0 : 1;
+	}
+
+	return NumPivots;
+}
+
+void URopeComponent::SaveRewindPivots(FPlayerRewindPivot* OutPivots, const int32 NumPivots) const
+{
+	//the number of pivots we've saved so far
+	int32 NumSaved = 0;
+
+	//iterate through the rope points until we've saved all the pivots
+	for (int32 Index = 0; Index < RopePoints.Num() && NumSaved < NumPivots; ++Index)
+	{
+		//check if the rope point is a simulated verlet point (rebuilt when restoring)
+		const FRopePoint& RopePoint = RopePoints[Index];
+		if (RopePoint.IsSimulated())
+		{
+			continue;
+		}
+
+		//set the flags (using the same flags as the replicated pivots)
+		FPlayerRewindPivot& Pivot = OutPivots[NumSaved++];
+		Pivot.Flags = RopePoint.bIsCollisionPoint ? FRopeNetPivot::CollisionPoint : 0;
+		Pivot.Flags |= PlayerCharacter && RopePoint.Component && RopePoint.Component == PlayerCharacter->GetMesh() ? FRopeNetPivot::OwnerMesh : 0;
+
+		//check if the rope point is attached to an actor
+		if (RopePoint.AttachedActor)
+		{
+			//save the location relative to the attached actor
+			Pivot.AttachedActor = RopePoint.AttachedActor;
+			Pivot.Location = FVector3f(RopePoint.Location);
+		}
+		else
+		{
+			//save the location relative to the owner's location
+			Pivot.Flags |= FRopeNetPivot::OwnerRelative;
+			Pivot.AttachedActor = nullptr;
+			Pivot.Location = FVector3f(RopePoint.GetWL() - GetOwner()->GetActorLocation());
+		}
+	}
+}
+
+void URopeComponent::RestoreRewindPivots(const FPlayerRewindPivot* Pivots, const int32 NumPivots)
+{
+	//check if we don't have enough pivots for a rope
+	if (NumPivots < 2)
+	{
+		//check if the rope is active
+		if (bIsRopeActive)
+		{
+			//deactivate the rope
+			DeactivateRope();
+		}
+
+		return;
+	}
+
+	//reset the rope points and constraints (keeps the allocations)
+	RopePoints.Reset(NumPivots);
+	Constraints.Reset();
+	CollisionPoints.Reset();
+
+	//iterate through the pivots
+	for (int32 Index = 0; Index < NumPivots; ++Index)
+	{
+		//add a rope point for the pivot
+		const FPlayerRewindPivot& Pivot = Pivots[Index];
+		FRopePoint& RopePoint = RopePoints.AddDefaulted_GetRef();
+		RopePoint.bIsCollisionPoint = (Pivot.Flags & FRopeNetPivot::CollisionPoint) != 0;
+		RopePoint.Component = (Pivot.Flags & FRopeNetPivot::OwnerMesh) != 0 && PlayerCharacter ? PlayerCharacter->GetMesh() : nullptr;
+
+		//check if the pivot is relative to the owner's location
+		if ((Pivot.Flags & FRopeNetPivot::OwnerRelative) != 0)
+		{
+			//pin the rope point at its world location (so the verlet simulation doesn't move it)
+			RopePoint.bUseWorldSpace = true;
+			RopePoint.bIsPinned = true;
+			RopePoint.Location = GetOwner()->GetActorLocation() + FVector(Pivot.Location);
+			continue;
+		}
+
+		//set the attached actor and relative location
+		RopePoint.AttachedActor = Pivot.AttachedActor.Get();
+		RopePoint.Location = FVector(Pivot.Location);
+	}
 
 	//check if we're using verlet integration
 	if (bUseVerletIntegration)
 	{
-		//add the extra verlet points
-		for (int Index = 0; Index < NumVerletPoints - 1; ++Index)
+		//add the verlet points between the ends of the rope
+		AddVerletPoints();
+	}
+
+	//remove the niagara components for rope segments that don't exist anymore
+	TrimNiagaraComponents(RopePoints.Num() - 1);
+
+	//set the active state to true
+	bIsRopeActive = true;
+}
+
+bool URopeComponent::ShouldReplicateNetState() const
+{
+	return GetIsReplicated() && GetOwnerRole() == ROLE_Authority && GetNetMode() != NM_Standalone;
+}
+
+bool URopeComponent::ShouldUseNetState() const
+{
+	return GetIsReplicated() && GetOwnerRole() == ROLE_SimulatedProxy;
+}
+
+void URopeComponent::LogNetBandwidth()
+{
+	//check if a second has passed since the last log
+	const double Now = GetWorld()->GetTimeSeconds();
+	const double Elapsed = Now - LastNetBandwidthLogTime;
+	if (Elapsed < 1)
+	{
+		return;
+	}
+
+	//get the number of clients the pivots are sent to
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	const int32 NumConnections = NetDriver ? NetDriver->ClientConnections.Num() : 0;
+
+	//print the measured bandwidth (per client, counting the fast array headers but not the packet overhead)
+	const double BytesPerSecond = NetState.NumBitsSent / 8.0 / Elapsed;
+	UE_LOG(LogTemp, Display, TEXT("RopeNet: %s sent %.0f bytes/s of pivots (%.0f bytes/s per client, %d clients, %d pivots)"), *GetOwner()->GetName(), BytesPerSecond, BytesPerSecond / FMath::Max(NumConnections, 1), NumConnections, NetState.Pivots.Num());
+
+	//start the next measurement
+	NetState.NumBitsSent = 0;
+	LastNetBandwidthLogTime = Now;
+}
+
+void URopeComponent::UpdateNetState()
+{
+	//the number of pivots we've packed so far
+	int32 NumPivots = 0;
+
+	//iterate through all the rope points
+	for (const FRopePoint& RopePoint : RopePoints)
+	{
+		//check if the rope point is a simulated verlet point (clients simulate those themselves)
+		if (RopePoint.IsSimulated())
+		{
+			continue;
+		}
+
+		//check if we've run out of pivot indices
+		if (NumPivots > MAX_uint8)
 		{
-			//get how far along the rope the verlet point should be
-			const float Alpha = float(Index + 1) / float(NumVerletPoints + 1);
+			break;
+		}
 
-			//the position of the rope point interpolated between the two rope points
-			const FVector Position = RopePoints[0].GetWL() + Direction * Alpha;
+		//pack the rope point into a temporary pivot
+		FRopeNetPivot NewPivot;
+		PackNetPivot(RopePoint, NewPivot);
+		NewPivot.PivotIndex = uint8(NumPivots);
 
-			//add the verlet point to the rope
-			RopePoints.Insert(FRopePoint(Position), RopePoints.Num() - 1);
+		//check if we need to add a new pivot
+		if (!NetState.Pivots.IsValidIndex(NumPivots))
+		{
+			//add the pivot and mark it as dirty
+			NetState.MarkItemDirty(NetState.Pivots.Add_GetRef(NewPivot));
+		}
+		else
+		{
+			//get the existing pivot
+			FRopeNetPivot& Pivot = NetState.Pivots[NumPivots];
 
-			////draw a debug sphere at the position of the verlet point
-			//DrawDebugSphere(GetWorld(), Position, 5, 6, FColor::Red, false, 5.f, 0, 5.f);
+			//check if the pivot changed by more than the quantisation step
+			if (Pivot.PivotIndex != NewPivot.PivotIndex || Pivot.Flags != NewPivot.Flags || Pivot.AttachedActor != NewPivot.AttachedActor || !Pivot.Location.Equals(NewPivot.Location, 0.1f))
+			{
+				//update the pivot (keeping its replication id) and mark it as dirty
+				Pivot.PivotIndex = NewPivot.PivotIndex;
+				Pivot.Flags = NewPivot.Flags;
+				Pivot.AttachedActor = NewPivot.AttachedActor;
+				Pivot.Location = NewPivot.Location;
+				NetState.MarkItemDirty(Pivot);
+			}
 		}
 
-		//get the distance between of the constraint
-		const float Dist = Direction.Size() / (NumVerletPoints + 1) * (1 - Stiffness);
+		//increment the number of pivots
+		++NumPivots;
+	}
 
-		//add the constraints
-		for (int Index = 0; Index < RopePoints.Num() - 1; ++Index)
+	//check if we have pivots we don't need anymore
+	if (NetState.Pivots.Num() > NumPivots)
+	{
+		//remove the pivots and mark the array as dirty
+		NetState.Pivots.RemoveAt(NumPivots, NetState.Pivots.Num() - NumPivots);
+		NetState.MarkArrayDirty();
+	}
+}
+
+void URopeComponent::ApplyNetState()
+{
+	//clear the dirty flag
+	NetState.bPivotsDirty = false;
+
+	//get the pivots sorted by their index
+	TArray<const FRopeNetPivot*, TInlineAllocator<16>> SortedPivots;
+	for (const FRopeNetPivot& Pivot : NetState.Pivots)
+	{
+		SortedPivots.Add(&Pivot);
+	}
+	SortedPivots.Sort([](const FRopeNetPivot& A, const FRopeNetPivot& B) { return A.PivotIndex < B.PivotIndex; });
+
+	//check if we don't have enough pivots for a rope
+	if (SortedPivots.Num() < 2)
+	{
+		//check if the rope is active
+		if (bIsRopeActive)
 		{
-			//get how far along the rope the the constraint is
-			const float Alpha = float(Index + 1) / float(NumVerletPoints + 1);
+			//deactivate the rope
+			DeactivateRope();
+		}
 
-			//get the value of constraint compensation 1 curve
-			const float Compensation1 = ConstraintCompensation1Curve->GetFloatValue(Alpha);
+		return;
+	}
 
-			//get the value of constraint compensation 2 curve
-			const float Compensation2 = ConstraintCompensation2Curve->GetFloatValue(Alpha);
+	//check if we can keep the simulated verlet points (only the ends of a verlet rope are pivots)
+	if (bIsRopeActive && bUseVerletIntegration && SortedPivots.Num() == 2 && RopePoints.Num() >= 2)
+	{
+		//update the ends of the rope
+		UnpackNetPivot(*SortedPivots[0], RopePoints[0]);
+		UnpackNetPivot(*SortedPivots[1], RopePoints.Last());
+	}
+	else
+	{
+		//reset the rope points and constraints (keeps the allocations)
+		RopePoints.Reset(SortedPivots.Num());
+		Constraints.Reset();
+		CollisionPoints.Reset();
 
-			//add the constraint to the rope
-			Constraints.Add(FVerletConstraint(&RopePoints[Index], &RopePoints[Index + 1], Compensation1, Compensation2, Dist));
+		//iterate through the sorted pivots
+		for (const FRopeNetPivot* Pivot : SortedPivots)
+		{
+			//unpack the pivot into a new rope point
+			UnpackNetPivot(*Pivot, RopePoints.AddDefaulted_GetRef());
+		}
 
-			////draw a debug sphere in the middle of the constraint
-			//DrawDebugSphere(GetWorld(), RopePoints[Index].GetWL() + Direction * Alpha / 2, Dist / 2, 6, FColor::Green, false, 5.f, 0, 5.f);
+		//check if we're using verlet integration
+		if (bUseVerletIntegration)
+		{
+			//add the verlet points between the ends of the rope
+			AddVerletPoints();
 		}
+
+		//remove the niagara components for rope segments that don't exist anymore
+		TrimNiagaraComponents(RopePoints.Num() - 1);
 	}
 
-	////set the old locations of the rope points
-	//SetRopeOldLocations(GetWorld()->GetDeltaSeconds());
+	//set the active state to true
+	bIsRopeActive = true;
+
+	//get the actor at the end of the rope
+	const AActor* EndActor = RopePoints.Last().AttachedActor;
+
+	//set the grappleable component (through the registered targets if we have the grapple target subsystem)
+	GrappleableComponent = GrappleTargetSubsystem ? GrappleTargetSubsystem->FindGrappleable(EndActor) : EndActor ? EndActor->FindComponentByClass<UGrappleableComponent>() : nullptr;
+}
+
+void URopeComponent::PackNetPivot(const FRopePoint& RopePoint, FRopeNetPivot& OutPivot) const
+{
+	//set the flags that don't depend on the location
+	OutPivot.Flags = RopePoint.bIsCollisionPoint ? FRopeNetPivot::CollisionPoint : 0;
+
+	//check if the rope point follows the owner's mesh
+	if (PlayerCharacter && RopePoint.Component && RopePoint.Component == PlayerCharacter->GetMesh())
+	{
+		OutPivot.Flags |= FRopeNetPivot::OwnerMesh;
+	}
+
+	//check if the rope point is attached to an actor that clients can resolve
+	if (RopePoint.AttachedActor && RopePoint.AttachedActor->IsSupportedForNetworking())
+	{
+		//send the location relative to the attached actor (it doesn't change while the actor moves)
+		OutPivot.AttachedActor = RopePoint.AttachedActor;
+		OutPivot.Location = RopePoint.Location;
+	}
+	else
+	{
+		//send the world location (it doesn't change while the owner moves, so the pivot isn't resent)
+		OutPivot.Flags |= FRopeNetPivot::WorldLocation;
+		OutPivot.AttachedActor = nullptr;
+		OutPivot.Location = RopePoint.GetWL();
+	}
+}
+
+void URopeComponent::UnpackNetPivot(const FRopeNetPivot& Pivot, FRopePoint& OutRopePoint) const
+{
+	//reset the rope point
+	OutRopePoint = FRopePoint();
+
+	//set the collision point flag
+	OutRopePoint.bIsCollisionPoint = (Pivot.Flags & FRopeNetPivot::CollisionPoint) != 0;
+
+	//check if the pivot follows the owner's mesh
+	if ((Pivot.Flags & FRopeNetPivot::OwnerMesh) != 0 && PlayerCharacter)
+	{
+		//bind the rope point to the owner (the mesh's socket is used for its location)
+		OutRopePoint.Component = PlayerCharacter->GetMesh();
+		OutRopePoint.AttachedActor = GetOwner();
+		OutRopePoint.Location = (Pivot.Flags & FRopeNetPivot::WorldLocation) != 0 ? GetOwner()->GetTransform().InverseTransformPosition(Pivot.Location) : Pivot.Location;
+
+		return;
+	}
+
+	//check if the pivot has a world location
+	if ((Pivot.Flags & FRopeNetPivot::WorldLocation) != 0)
+	{
+		//pin the rope point in place (so the verlet simulation doesn't move it)
+		OutRopePoint.bUseWorldSpace = true;
+		OutRopePoint.bIsPinned = true;
+		OutRopePoint.Location = Pivot.Location;
+
+		return;
+	}
+
+	//set the attached actor and relative location
+	OutRopePoint.AttachedActor = Pivot.AttachedActor;
+	OutRopePoint.Location = Pivot.Location;
+}
+
+void URopeComponent::TrimNiagaraComponents(const int32 NumSegments)
+{
+	//remove the niagara components we don't need anymore
+	while (NiagaraComponents.Num() > FMath::Max(NumSegments, 0))
+	{
+		//check if the niagara component is valid
+		if (NiagaraComponents.Last()->IsValidLowLevelFast())
+		{
+			//destroy the niagara component
+			NiagaraComponents.Last()->DestroyComponent();
+		}
+
+		//remove the niagara component from the array
+		NiagaraComponents.Pop();
+	}
 }
 
 FVector URopeComponent::GetRopeDirection() const
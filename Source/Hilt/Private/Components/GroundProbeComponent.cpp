@@ -0,0 +1,114 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Components/GroundProbeComponent.h"
+
+#include "Core/HiltProfiling.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+
+UGroundProbeComponent::UGroundProbeComponent()
+{
+	//set the tick function to be enabled
+	PrimaryComponentTick.bCanEverTick = true;
+}
+
+void UGroundProbeComponent::BeginPlay()
+{
+	//call the parent implementation
+	Super::BeginPlay();
+
+	//setup the query params (ignore the owner and return the physical material of the ground)
+	QueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(GroundProbe), false, GetOwner());
+	QueryParams.bReturnPhysicalMaterial = true;
+
+	//bind the async probe delegate
+	ProbeTraceDelegate.BindUObject(this, &UGroundProbeComponent::OnProbeTraceDone);
+}
+
+void UGroundProbeComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	//call the parent implementation
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	//check if we shouldn't probe every frame
+	if (!bProbeEveryFrame)
+	{
+		return;
+	}
+
+	//get the start and end of the probe
+	FVector Start;
+	FVector End;
+	GetProbeStartEnd(ProbeDistance, Start, End);
+
+	//start the async probe (the delegate is called once the result is ready next frame)
+	HILT_COUNT_SCENE_QUERY();
+	GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, Start, End, CollisionChannel, QueryParams, FCollisionResponseParams::DefaultResponseParam, &ProbeTraceDelegate);
+}
+
+bool UGroundProbeComponent::IsResultFresh() const
+{
+	//check if we've had a result and it's not too old
+	return GroundResult.Frame != 0 && GFrameCounter - GroundResult.Frame <= static_cast<uint64>(MaxResultAge);
+}
+
+bool UGroundProbeComponent::HasGroundWithin(const float Distance, const bool bRequireSameFrame)
+{
+	//check if we can use the async result (it has to be fresh and have probed at least as far as the distance)
+	if (!bRequireSameFrame && IsResultFresh() && Distance <= ProbeDistance)
+	{
+		return GroundResult.bStartPenetrating || (GroundResult.bHasGround && GroundResult.Distance <= Distance);
+	}
+
+	//probe synchronously
+	const FGroundProbeResult Result = ProbeGroundSync(Distance);
+	return Result.bStartPenetrating || Result.bHasGround;
+}
+
+FGroundProbeResult UGroundProbeComponent::ProbeGroundSync(const float Distance) const
+{
+	//get the start and end of the probe
+	FVector Start;
+	FVector End;
+	GetProbeStartEnd(Distance, Start, End);
+
+	//do the line trace
+	HILT_COUNT_SCENE_QUERY();
+	FHitResult Hit;
+	GetWorld()->LineTraceSingleByChannel(Hit, Start, End, CollisionChannel, QueryParams);
+
+	//fill the result
+	FGroundProbeResult Result;
+	FillResult(Hit, Start, Distance, Result);
+	Result.Frame = GFrameCounter;
+
+	return Result;
+}
+
+void UGroundProbeComponent::OnProbeTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	//fill the result from the first hit (or no hit)
+	FillResult(TraceDatum.OutHits.IsEmpty() ? FHitResult() : TraceDatum.OutHits[0], TraceDatum.Start, ProbeDistance, GroundResult);
+
+	//store the frame the result is from
+	GroundResult.Frame = GFrameCounter;
+}
+
+void UGroundProbeComponent::GetProbeStartEnd(const float Distance, FVector& OutStart, FVector& OutEnd) const
+{
+	//probe straight down from the owner's location
+	OutStart = GetOwner()->GetActorLocation();
+	OutEnd = OutStart - FVector::UpVector * Distance;
+}
+
+void UGroundProbeComponent::FillResult(const FHitResult& Hit, const FVector& Start, const float Distance, FGroundProbeResult& OutResult)
+{
+	//set the hit values
+	OutResult.bHasGround = Hit.IsValidBlockingHit();
+	OutResult.bStartPenetrating = Hit.bStartPenetrating;
+	OutResult.ProbeStart = Start;
+	OutResult.Distance = OutResult.bHasGround ? Hit.Distance : Distance;
+	OutResult.Location = OutResult.bHasGround ? FVector(Hit.ImpactPoint) : Start - FVector::UpVector * Distance;
+	OutResult.Normal = OutResult.bHasGround ? FVector(Hit.ImpactNormal) : FVector::UpVector;
+	OutResult.PhysicalMaterial = OutResult.bHasGround ? Hit.PhysMaterial.Get() : nullptr;
+}
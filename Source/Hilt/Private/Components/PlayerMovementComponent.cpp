@@ -1,8 +1,12 @@
 #include "Components/PlayerMovementComponent.h"
 
 #include "Components/CapsuleComponent.h"
+#include "Components/GroundProbeComponent.h"
 #include "Components/Camera/PlayerCameraComponent.h"
 #include "Components/GrapplingHook/RopeComponent.h"
+#include "Core/HiltProfiling.h"
+#include "Core/HiltSimulationSubsystem.h"
+#include "Core/Math/BakedCurve.h"
 #include "GameFramework/PhysicsVolume.h"
 #include "InteractableObjects/PylonObjective.h"
 #include "NPC/Components/GrappleableComponent.h"
@@ -54,15 +58,14 @@ FVector UPlayerMovementComponent::ApplySpeedLimit(const FVector& InVelocity, con
 
 float UPlayerMovementComponent::GetCurrentSpeedLimit() const
 {
-	//check if we don't have a valid player pawn
-	if (!PlayerPawn)
-	{
-		return SpeedLimit;
-	}
-
-	//return the speed limit multiplied by the speed limit modifier
-	return SpeedLimit * PlayerPawn->ScoreComponent->GetCurrentScoreValues().SpeedLimitModifier;
+	//return the speed limit multiplied by the speed limit modifier of the current score tier
+	return SpeedLimit * ScoreSpeedLimitModifier;
+}
 
+void UPlayerMovementComponent::OnScoreTierChanged(int32 NewTier, int32 OldTier)
+{
+	//cache the speed limit modifier of the new score tier
+	ScoreSpeedLimitModifier = PlayerPawn->ScoreComponent->GetScoreValues().SpeedLimitModifier;
 }
 
 void UPlayerMovementComponent::StartSlide()
@@ -87,17 +90,20 @@ void UPlayerMovementComponent::StartSlide()
 	//set the current slide speed
 	CurrentSlideSpeed = Velocity.Size();
 
-	//check if we're not already sliding
-	if (!bIsSliding)
+	//check if we're not already sliding and this isn't a replayed move
+	if (!bIsSliding && !IsReplayingMoves())
 	{
 		//call the blueprint event
 		OnPlayerStartSlide.Broadcast();
 
 		//set the slide start time
-		SlideStartTime = GetWorld()->GetTimeSeconds();
+		SlideStartTime = UHiltSimulationSubsystem::GetGameplayTime(this);
 
-		//bind the slide score banking timer
-		GetWorld()->GetTimerManager().SetTimer(SlideScoreBankTimer, this, &UPlayerMovementComponent::BankSlideScore, SlideScoreBankRate, true);
+		//start the slide score banking timer
+		if (UHiltTimerSubsystem* TimerSubsystem = UHiltTimerSubsystem::Get(this))
+		{
+			TimerSubsystem->SetTimer(SlideScoreBankTimer, this, &UPlayerMovementComponent::BankSlideScore, SlideScoreBankRate, true);
+		}
 	}
 
 	//set the sliding variable
@@ -105,10 +111,36 @@ void UPlayerMovementComponent::StartSlide()
 
 	//stop diving (if we are)
 	StopDive();
+
+	//check if we're on the ground and not in the slide movement mode yet (or anymore, if a grapple took us out of it)
+	if (IsWalking() && !IsSliding() && !PlayerPawn->GrappleComponent->bIsGrappling)
+	{
+		//enter the slide movement mode
+		SetMovementMode(MOVE_Custom, CMOVE_Slide);
+	}
 }
 
 void UPlayerMovementComponent::StopSlide()
 {
+	//set the sliding variable
+	bIsSliding = false;
+
+	//check if we're still in the slide movement mode
+	if (IsSliding())
+	{
+		//go back to walking
+		SetMovementMode(MOVE_Walking);
+	}
+
+	//reset the slide speed gained
+	SlideSpeedGained = 0;
+
+	//check if this is a replayed move (the score and events already happened when the move was first simulated)
+	if (IsReplayingMoves())
+	{
+		return;
+	}
+
 	//check if we're on the ground
 	if (IsWalking())
 	{
@@ -122,22 +154,19 @@ void UPlayerMovementComponent::StopSlide()
 	//set the pending slide score to 0
 	PendingSlideScore = 0;
 
-	//set the sliding variable
-	bIsSliding = false;
-
-	//reset the slide speed gained
-	SlideSpeedGained = 0;
-
 	//call the blueprint event
 	OnPlayerStopSlide.Broadcast();
 
-	//unbind the slide score banking timer
-	GetWorld()->GetTimerManager().ClearTimer(SlideScoreBankTimer);
+	//stop the slide score banking timer
+	if (UHiltTimerSubsystem* TimerSubsystem = UHiltTimerSubsystem::Get(this))
+	{
+		TimerSubsystem->ClearTimer(SlideScoreBankTimer);
+	}
 }
 
 bool UPlayerMovementComponent::IsSliding() const
 {
-	return bIsSliding && IsWalking() && !IsFalling() && !PlayerPawn->GrappleComponent->bIsGrappling;
+	return IsCustomMovementMode(CMOVE_Slide) && !PlayerPawn->GrappleComponent->bIsGrappling;
 }
 
 void UPlayerMovementComponent::BankSlideScore()
@@ -152,6 +181,33 @@ void UPlayerMovementComponent::BankSlideScore()
 	SlideSpeedGained = 0;
 }
 
+void UPlayerMovementComponent::RestoreSlideState(const bool bSliding, const float InPendingSlideScore, const float InSlideSpeedGained)
+{
+	//restore the slide state and the score that hasn't been banked yet
+	bIsSliding = bSliding;
+	PendingSlideScore = InPendingSlideScore;
+	SlideSpeedGained = InSlideSpeedGained;
+
+	//get the timer subsystem
+	UHiltTimerSubsystem* TimerSubsystem = UHiltTimerSubsystem::Get(this);
+	if (!TimerSubsystem)
+	{
+		return;
+	}
+
+	//check if we're sliding and not banking the slide score
+	if (bSliding && !TimerSubsystem->IsTimerActive(SlideScoreBankTimer))
+	{
+		//start the slide score banking timer (from a full interval, the phase isn't recorded)
+		TimerSubsystem->SetTimer(SlideScoreBankTimer, this, &UPlayerMovementComponent::BankSlideScore, SlideScoreBankRate, true);
+	}
+	else if (!bSliding)
+	{
+		//stop the slide score banking timer
+		TimerSubsystem->ClearTimer(SlideScoreBankTimer);
+	}
+}
+
 void UPlayerMovementComponent::BeginPlay()
 {
 	//call the parent implementation
@@ -160,12 +216,45 @@ void UPlayerMovementComponent::BeginPlay()
 	//get our owner as a player pawn
 	PlayerPawn = Cast<APlayerCharacter>(GetOwner());
 
-	//set the default gravity scale
+	//set the default gravity scale and simulation iterations
 	DefaultGravityScale = GravityScale;
+	DefaultMaxSimulationIterations = MaxSimulationIterations;
+
+	//check if we have a score component
+	if (PlayerPawn && PlayerPawn->ScoreComponent)
+	{
+		//cache the score values of the current score tier and recache them whenever it changes
+		PlayerPawn->ScoreComponent->OnScoreTierChanged.AddDynamic(this, &UPlayerMovementComponent::OnScoreTierChanged);
+		OnScoreTierChanged(PlayerPawn->ScoreComponent->ScoreTier, PlayerPawn->ScoreComponent->ScoreTier);
+	}
+
+	//bake the curves we evaluate every tick
+	HiltCurves::BakeReferencedCurves(this);
+
+	//start recording telemetry if it's enabled (not on dedicated servers, there's no local player to record)
+	if (GetNetMode() != NM_DedicatedServer)
+	{
+		TelemetryWriter = FMovementTelemetryWriter::CreateFromCommandLine(FString::Printf(TEXT("Movement_%s"), *GetOwner()->GetName()));
+	}
+}
+
+void UPlayerMovementComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	//stop recording telemetry (waits for the writer thread to write what's left)
+	TelemetryWriter.Reset();
+
+	//call the parent implementation
+	Super::EndPlay(EndPlayReason);
 }
 
 void UPlayerMovementComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
+	//record the state the last step left the local player in for rewinding (before this step changes it)
+	if (PlayerPawn && PlayerPawn->IsLocallyControlled())
+	{
+		PlayerPawn->CaptureRewindFrame();
+	}
+
 	//call the parent implementation
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
@@ -174,6 +263,38 @@ void UPlayerMovementComponent::TickComponent(float DeltaTime, ELevelTick TickTyp
 
 	//clamp the excess speed
 	ExcessSpeed = FMath::Clamp(ExcessSpeed, 0.f, MaxExcessSpeed);
+
+	//check if we're recording telemetry for the local player
+	if (TelemetryWriter && CharacterOwner && CharacterOwner->IsLocallyControlled())
+	{
+		RecordTelemetry();
+	}
+}
+
+void UPlayerMovementComponent::RecordTelemetry() const
+{
+	//fill the record
+	FMovementTelemetryRecord Record;
+	Record.Frame = static_cast<uint32>(GFrameCounter);
+	Record.Time = static_cast<float>(UHiltSimulationSubsystem::GetGameplayTime(this));
+	Record.Location = FVector3f(UpdatedComponent->GetComponentLocation());
+	Record.Velocity = FVector3f(Velocity);
+	Record.MovementMode = MovementMode;
+
+	//set the state flags
+	Record.Flags |= bIsSliding ? MovementTelemetry_Sliding : 0;
+	Record.Flags |= bIsDiving ? MovementTelemetry_Diving : 0;
+	Record.Flags |= bIsSlideJumping ? MovementTelemetry_SlideJumping : 0;
+	Record.Flags |= bIsSlideFalling ? MovementTelemetry_SlideFalling : 0;
+	Record.Flags |= PlayerPawn->GrappleComponent->bIsGrappling ? MovementTelemetry_Grappling : 0;
+	Record.Flags |= bIsSpeedLimited ? MovementTelemetry_SpeedLimited : 0;
+
+	//set the score
+	Record.Score = PlayerPawn->ScoreComponent->Score;
+	Record.ScoreTier = static_cast<uint8>(FMath::Clamp(PlayerPawn->ScoreComponent->ScoreTier, 0, 255));
+
+	//push it to the writer thread
+	TelemetryWriter->Record(Record);
 }
 
 FVector UPlayerMovementComponent::GetSlideSurfaceDirection()
@@ -190,16 +311,27 @@ FVector UPlayerMovementComponent::GetSlideSurfaceDirection()
 void UPlayerMovementComponent::StartDive()
 {
 	//check if we're already diving or if we're slide jumping
-	if (bIsDiving || IsDiving() || bIsSlideJumping)
+	if (IsDiving() || bIsSlideJumping)
 	{
 		return;
 	}
 
-	//set the diving variable
-	bIsDiving = true;
+	//check if this is a new dive (and not a dive a grapple took us out of)
+	if (!bIsDiving)
+	{
+		//set the diving variable
+		bIsDiving = true;
 
-	//set the dive start time
-	DiveStartTime = GetWorld()->GetTimeSeconds();
+		//set the dive start time
+		DiveStartTime = UHiltSimulationSubsystem::GetGameplayTime(this);
+	}
+
+	//check if we're in the air and not grappling
+	if (IsFalling() && !PlayerPawn->GrappleComponent->bIsGrappling)
+	{
+		//enter the dive movement mode
+		SetMovementMode(MOVE_Custom, CMOVE_Dive);
+	}
 }
 
 void UPlayerMovementComponent::StopDive()
@@ -213,8 +345,15 @@ void UPlayerMovementComponent::StopDive()
 	//set the diving variable
 	bIsDiving = false;
 
+	//check if we're still in the dive movement mode
+	if (IsDiving())
+	{
+		//go back to falling
+		SetMovementMode(MOVE_Falling);
+	}
+
 	//set the dive stop time
-	DiveStopTime = GetWorld()->GetTimeSeconds();
+	DiveStopTime = UHiltSimulationSubsystem::GetGameplayTime(this);
 
 	//set the gravity scale to the default gravity scale
 	GravityScale = DefaultGravityScale;
@@ -222,130 +361,202 @@ void UPlayerMovementComponent::StopDive()
 
 bool UPlayerMovementComponent::IsDiving() const
 {
-	return bIsDiving && IsFalling() && !PlayerPawn->GrappleComponent->bIsGrappling;
+	return IsCustomMovementMode(CMOVE_Dive) && !PlayerPawn->GrappleComponent->bIsGrappling;
 }
 
-void UPlayerMovementComponent::PhysWalking(float deltaTime, int32 Iterations)
+void UPlayerMovementComponent::PhysFalling(float deltaTime, int32 Iterations)
 {
-	//check if we're sliding
-	if (IsSliding())
+	//check if we're slide falling
+	if (bIsSlideFalling)
 	{
+		//set the velocity to the direction of the camera
+		Velocity = PlayerPawn->Camera->GetForwardVector() * Velocity.Size();
+
 		//rotate the character to the velocity direction
 		GetCharacterOwner()->SetActorRotation(Velocity.Rotation());
 
-		//get the normal of the surface we're sliding on
-		const FVector SlideNormal = CurrentFloor.HitResult.ImpactNormal;
-
-		//get the direction of gravity along the slide surface
-		const FVector GravitySurfaceDirection = GetSlideSurfaceDirection();
-
-		//get the dot product of the gravity direction and the slide direction
-		const float DotProduct = 1 - FVector::DotProduct(SlideNormal, -GetGravityDirection());
-
-		//get the sign of the dot product of the gravity surface direction and the velocity
-		float Sign = FMath::Sign(FVector::DotProduct(Velocity, GravitySurfaceDirection));
-
-		//check if the sign is 0
-		if (Sign == 0)
+		//check if we should stop slide jumping
+		if (UHiltSimulationSubsystem::GetGameplayTime(this) > SlideFallStartTime + SlideFallStopDelay)
 		{
-			//set the sign to 1
-			Sign = 1;
+			//set the slide falling variable to false
+			bIsSlideFalling = false;
 		}
+	}
 
-		//check if the slide gravity curve is valid
-		if (PlayerPawn->ScoreComponent->GetCurrentScoreValues().SlideGravityCurve->IsValidLowLevelFast())
-		{
-			//add the increase in speed to the current slide speed
-			CurrentSlideSpeed += Sign * GravitySurfaceDirection.Size() * PlayerPawn->ScoreComponent->GetCurrentScoreValues().SlideGravityCurve->GetFloatValue(DotProduct) * deltaTime;
-
-			//check if the sign is positive
-			if (Sign > 0)
-			{
-				//add the increase in speed to the slide speed gained
-				SlideSpeedGained += Sign * GravitySurfaceDirection.Size() * PlayerPawn->ScoreComponent->GetCurrentScoreValues().SlideGravityCurve->GetFloatValue(DotProduct) * deltaTime;
-			}
+	//check if we might be bunny jumping and there's no ground within the bunny jump trace distance (uses the ground probe's async result, probing synchronously only if it's stale)
+	if (bMightBeBunnyJumping && !PlayerPawn->GroundProbeComponent->HasGroundWithin(AvoidBunnyJumpTraceDistance, bSyncBunnyJumpProbe))
+	{
+		//set might be bunny jumping to false
+		bMightBeBunnyJumping = false;
+	}
 
+	//check if we're slide jumping
+	if (bIsSlideJumping)
+	{
+		//set the velocity to be the direction of the camera
+		Velocity = PlayerPawn->Camera->GetForwardVector() * Velocity.Size();
 
-			//add the slide gravity to the velocity
-			Velocity = ApplySpeedLimit(Velocity + GravitySurfaceDirection * PlayerPawn->ScoreComponent->GetCurrentScoreValues().SlideGravityCurve->GetFloatValue(DotProduct) * deltaTime, deltaTime);
+		//rotate the character to the velocity direction
+		GetCharacterOwner()->SetActorRotation(Velocity.Rotation());
+	}
 
-			//get the fall speed limit from the score component
-			const float FallSpeedLimit = PlayerPawn->ScoreComponent->GetCurrentScoreValues().FallSpeedLimit;
+	//delegate to the parent implementation
+	Super::PhysFalling(deltaTime, Iterations);
+}
 
-			//clamp the result to the fall speed limit
-			Velocity = Velocity.GetClampedToMaxSize(FallSpeedLimit);
-		}
+void UPlayerMovementComponent::PhysCustom(float deltaTime, int32 Iterations)
+{
+	//simulate the custom movement mode we're in
+	switch (CustomMovementMode)
+	{
+	case CMOVE_Slide:
+		PhysSlide(deltaTime, Iterations);
+		break;
+	case CMOVE_Dive:
+		PhysDive(deltaTime, Iterations);
+		break;
+	default:
+		Super::PhysCustom(deltaTime, Iterations);
+		break;
+	}
+}
 
-		//check if the slide start time + SlideScoreDecayStopDelay is less than the current time
-		if (SlideStartTime + SlideScoreDecayStopDelay < GetWorld()->GetTimeSeconds())
-		{
-			//stop the score degredation timer
-			PlayerPawn->ScoreComponent->StopDegredationTimer();
-		}
+bool UPlayerMovementComponent::IsMovingOnGround() const
+{
+	//sliding counts as moving on the ground
+	return Super::IsMovingOnGround() || (UpdatedComponent && IsCustomMovementMode(CMOVE_Slide));
+}
 
-		//check if we have a valid slide score curve
-		if (SlideScoreCurve->IsValidLowLevelFast())
-		{
-			//get the slide score value
-			const float SlideScore = SlideScoreCurve->GetFloatValue(SlideSpeedGained / SpeedLimit * PlayerPawn->ScoreComponent->GetCurrentScoreValues().SpeedLimitModifier);
+bool UPlayerMovementComponent::IsFalling() const
+{
+	//diving counts as falling
+	return Super::IsFalling() || (UpdatedComponent && IsCustomMovementMode(CMOVE_Dive));
+}
 
-			//update the pending slide score
-			PendingSlideScore = SlideScore * PlayerPawn->ScoreComponent->GetCurrentScoreValues().ScoreGainMultiplier;
-		}
-	}
+bool UPlayerMovementComponent::IsCustomMovementMode(const EPlayerCustomMovementMode InCustomMovementMode) const
+{
+	return MovementMode == MOVE_Custom && CustomMovementMode == InCustomMovementMode;
+}
 
+void UPlayerMovementComponent::OnMovementModeChanged(const EMovementMode PreviousMovementMode, const uint8 PreviousCustomMode)
+{
 	//call the parent implementation
-	Super::PhysWalking(deltaTime, Iterations);
+	Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
+
+	//check if we started sliding
+	if (IsCustomMovementMode(CMOVE_Slide))
+	{
+		//find the floor and base like walking does (the parent implementation clears them for custom movement modes)
+		FindFloor(UpdatedComponent->GetComponentLocation(), CurrentFloor, false);
+		AdjustFloorHeight();
+		SetBaseFromFloor(CurrentFloor);
+	}
 }
 
-void UPlayerMovementComponent::PhysFalling(float deltaTime, int32 Iterations)
+void UPlayerMovementComponent::PhysSlide(float deltaTime, int32 Iterations)
 {
-	//check if we're slide falling
-	if (bIsSlideFalling)
+	//check if we're grappling
+	if (PlayerPawn->GrappleComponent->bIsGrappling)
 	{
-		//set the velocity to the direction of the camera
-		Velocity = PlayerPawn->Camera->GetForwardVector() * Velocity.Size();
+		//let the grapple move us with the walking movement mode (the slide picks back up when the grapple ends if slide is still held)
+		SetMovementMode(MOVE_Walking);
+		StartNewPhysics(deltaTime, Iterations);
+		return;
+	}
 
-		//rotate the character to the velocity direction
-		GetCharacterOwner()->SetActorRotation(Velocity.Rotation());
+	//rotate the character to the velocity direction
+	GetCharacterOwner()->SetActorRotation(Velocity.Rotation());
 
-		//check if we should stop slide jumping
-		if (GetWorld()->GetTimeSeconds() > SlideFallStartTime + SlideFallStopDelay)
-		{
-			//set the slide falling variable to false
-			bIsSlideFalling = false;
-		}
+	//get the normal of the surface we're sliding on
+	const FVector SlideNormal = CurrentFloor.HitResult.ImpactNormal;
+
+	//get the direction of gravity along the slide surface
+	const FVector GravitySurfaceDirection = GetSlideSurfaceDirection();
+
+	//get the dot product of the gravity direction and the slide direction
+	const float DotProduct = 1 - FVector::DotProduct(SlideNormal, -GetGravityDirection());
+
+	//get the sign of the dot product of the gravity surface direction and the velocity
+	float Sign = FMath::Sign(FVector::DotProduct(Velocity, GravitySurfaceDirection));
+
+	//check if the sign is 0
+	if (Sign == 0)
+	{
+		//set the sign to 1
+		Sign = 1;
 	}
 
-	//check if we might be bunny jumping
-	if (bMightBeBunnyJumping)
+	//check if the slide gravity curve is valid
+	if (PlayerPawn->ScoreComponent->GetScoreValues().SlideGravityCurve->IsValidLowLevelFast())
 	{
-		//storage for the line trace
-		FHitResult Hit;
+		//get the slide gravity for the surface we're sliding on
+		const float SlideGravity = HiltCurves::Evaluate(PlayerPawn->ScoreComponent->GetScoreValues().SlideGravityCurve, DotProduct);
 
-		//do a line trace straight down from the player with the bunny jump trace distance
-		GetWorld()->LineTraceSingleByChannel(Hit, GetOwner()->GetActorLocation(), GetOwner()->GetActorLocation() - FVector::UpVector * AvoidBunnyJumpTraceDistance, ECC_Visibility);
+		//add the increase in speed to the current slide speed
+		CurrentSlideSpeed += Sign * GravitySurfaceDirection.Size() * SlideGravity * deltaTime;
 
-		//check if it wasn't a valid blocking hit and we didn't start penetrating
-		if (!Hit.IsValidBlockingHit() && !Hit.bStartPenetrating)
+		//check if the sign is positive
+		if (Sign > 0)
 		{
-			//set might be bunny jumping to false
-			bMightBeBunnyJumping = false;
+			//add the increase in speed to the slide speed gained
+			SlideSpeedGained += Sign * GravitySurfaceDirection.Size() * SlideGravity * deltaTime;
 		}
+
+		//add the slide gravity to the velocity
+		Velocity = ApplySpeedLimit(Velocity + GravitySurfaceDirection * SlideGravity * deltaTime, deltaTime);
+
+		//get the fall speed limit from the score component
+		const float FallSpeedLimit = PlayerPawn->ScoreComponent->GetScoreValues().FallSpeedLimit;
+
+		//clamp the result to the fall speed limit
+		Velocity = Velocity.GetClampedToMaxSize(FallSpeedLimit);
 	}
 
-	//check if we're slide jumping
-	if (bIsSlideJumping)
+	//check if the slide start time + SlideScoreDecayStopDelay is less than the current time
+	if (SlideStartTime + SlideScoreDecayStopDelay < UHiltSimulationSubsystem::GetGameplayTime(this))
 	{
-		//set the velocity to be the direction of the camera
-		Velocity = PlayerPawn->Camera->GetForwardVector() * Velocity.Size();
+		//stop the score degredation timer
+		PlayerPawn->ScoreComponent->StopDegredationTimer();
+	}
 
-		//rotate the character to the velocity direction
-		GetCharacterOwner()->SetActorRotation(Velocity.Rotation());
+	//check if we have a valid slide score curve
+	if (SlideScoreCurve->IsValidLowLevelFast())
+	{
+		//get the slide score value
+		const float SlideScore = HiltCurves::Evaluate(SlideScoreCurve, SlideSpeedGained / SpeedLimit * PlayerPawn->ScoreComponent->GetScoreValues().SpeedLimitModifier);
+
+		//update the pending slide score
+		PendingSlideScore = SlideScore * PlayerPawn->ScoreComponent->GetScoreValues().ScoreGainMultiplier;
 	}
 
-	//delegate to the parent implementation
-	Super::PhysFalling(deltaTime, Iterations);
+	//get the slide friction for this frame
+	SlideParams.GroundFriction = HiltCurves::Evaluate(SlidingGroundFrictionCurve, Velocity.Size() / GetMaxSpeed());
+
+	//run the walking floor following, step ups and ledge checks with the slide parameters (walking off a ledge leaves the slide movement mode)
+	Super::PhysWalking(deltaTime, Iterations);
+}
+
+void UPlayerMovementComponent::PhysDive(float deltaTime, int32 Iterations)
+{
+	//check if we're grappling
+	if (PlayerPawn->GrappleComponent->bIsGrappling)
+	{
+		//let the grapple move us with the falling movement mode (the dive picks back up when the grapple ends if slide is still held)
+		SetMovementMode(MOVE_Falling);
+		StartNewPhysics(deltaTime, Iterations);
+		return;
+	}
+
+	//get the time since the dive started
+	const float DiveTime = UHiltSimulationSubsystem::GetGameplayTime(this) - DiveStartTime;
+
+	//get the dive curve values for this frame
+	DiveParams.TerminalVelocityMultiplier = DiveTerminalVelocityCurve->IsValidLowLevelFast() ? HiltCurves::Evaluate(DiveTerminalVelocityCurve, DiveTime) : 1;
+	DiveParams.AirControlMultiplier = DiveWasdCurve->IsValidLowLevelFast() ? HiltCurves::Evaluate(DiveWasdCurve, DiveTime) : 1;
+	DiveParams.MaxSpeedMultiplier = DiveMaxWasdSpeedCurve->IsValidLowLevelFast() ? HiltCurves::Evaluate(DiveMaxWasdSpeedCurve, DiveTime) : 1;
+
+	//run the falling integration with the dive parameters (landing ends the dive in ApplyImpactPhysicsForces)
+	PhysFalling(deltaTime, Iterations);
 }
 
 bool UPlayerMovementComponent::IsWalkable(const FHitResult& Hit) const
@@ -408,10 +619,76 @@ void UPlayerMovementComponent::PerformMovement(float DeltaTime)
 		Velocity = DeltaRotation.RotateVector(Velocity);
 	}
 
+	//update the substep time for this frame
+	UpdateAdaptiveSubstepTime(DeltaTime);
+
 	//call the parent implementation
 	Super::PerformMovement(DeltaTime);
 }
 
+float UPlayerMovementComponent::GetSimulationTimeStep(const float RemainingTime, const int32 Iterations) const
+{
+	//check if we're not substepping this frame
+	if (AdaptiveSubstepTime <= 0)
+	{
+		return Super::GetSimulationTimeStep(RemainingTime, Iterations);
+	}
+
+	//check if the remaining time fits in one substep or we're out of iterations (use all of the remaining time so none of it is lost)
+	if (RemainingTime <= AdaptiveSubstepTime * 1.01f || Iterations >= MaxSimulationIterations)
+	{
+		return FMath::Max(MIN_TICK_TIME, RemainingTime);
+	}
+
+	//split the remaining time evenly so the last substep isn't tiny
+	return FMath::Max(MIN_TICK_TIME, RemainingTime / FMath::CeilToFloat(RemainingTime / AdaptiveSubstepTime));
+}
+
+void UPlayerMovementComponent::UpdateAdaptiveSubstepTime(const float DeltaTime)
+{
+	//reset the substepping
+	AdaptiveSubstepTime = 0;
+	MaxSimulationIterations = DefaultMaxSimulationIterations;
+
+	//check if we shouldn't substep
+	if (!bUseAdaptiveSubstepping || !UpdatedComponent || !CharacterOwner || DeltaTime <= 0)
+	{
+		return;
+	}
+
+	//get how far we'll move this frame
+	const FVector Delta = Velocity * DeltaTime;
+	const float Distance = Delta.Size();
+
+	//check if we're slow enough to not need substepping
+	if (Distance <= MaxSubstepDistance)
+	{
+		return;
+	}
+
+	//setup the query params the same way the movement's own sweeps do
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(SubstepPreCheck), false, CharacterOwner);
+	FCollisionResponseParams ResponseParams;
+	InitCollisionParams(QueryParams, ResponseParams);
+
+	//sweep the capsule along this frame's movement (plus one substep of margin for acceleration)
+	const FVector Start = UpdatedComponent->GetComponentLocation();
+	const FVector End = Start + Delta + Delta / Distance * MaxSubstepDistance;
+	HILT_COUNT_SCENE_QUERY();
+	if (!GetWorld()->SweepTestByChannel(Start, End, UpdatedComponent->GetComponentQuat(), UpdatedComponent->GetCollisionObjectType(), GetPawnCapsuleCollisionShape(SHRINK_None), QueryParams, ResponseParams))
+	{
+		//nothing in the way, so one step can't tunnel or launch differently
+		return;
+	}
+
+	//split the frame into enough substeps to move at most the max substep distance in each (capped per frame)
+	const int32 NumSubsteps = FMath::Min(FMath::CeilToInt(Distance / MaxSubstepDistance), MaxSubstepsPerFrame);
+	AdaptiveSubstepTime = DeltaTime / NumSubsteps;
+
+	//make sure the movement modes are allowed enough iterations for the substeps
+	MaxSimulationIterations = FMath::Max(DefaultMaxSimulationIterations, NumSubsteps);
+}
+
 void UPlayerMovementComponent::HandleWalkingOffLedge(const FVector& PreviousFloorImpactNormal, const FVector& PreviousFloorContactNormal, const FVector& PreviousLocation, float TimeDelta)
 {
 	//call the parent implementation
@@ -439,20 +716,17 @@ FVector UPlayerMovementComponent::NewFallVelocity(const FVector& InitialVelocity
 		// Don't exceed terminal velocity.
 		float TerminalLimit = FMath::Abs(GetPhysicsVolume()->TerminalVelocity);
 
-		//check if we're diving and we have a valid DiveTerminalVelocityCurve
-		if (IsDiving() && DiveTerminalVelocityCurve->IsValidLowLevelFast())
+		//check if we're diving
+		if (IsDiving())
 		{
-			//get the value from the curve
-			const float TerminalVelMultiplier = DiveTerminalVelocityCurve->GetFloatValue(GetWorld()->GetTimeSeconds() - DiveStartTime);
-
-			//multiply the terminal limit by the value
-			TerminalLimit *= TerminalVelMultiplier;
+			//multiply the terminal limit by this frame's dive terminal velocity multiplier
+			TerminalLimit *= DiveParams.TerminalVelocityMultiplier;
 		}
-		//check if we're diving not diving and we have a valid AfterDiveTerminalVelocityCurve
-		else if (!IsDiving() && AfterDiveTerminalVelocityCurve->IsValidLowLevelFast())
+		//check if we're not diving and we have a valid AfterDiveTerminalVelocityCurve
+		else if (AfterDiveTerminalVelocityCurve->IsValidLowLevelFast())
 		{
 			//get the value from the curve
-			const float TerminalVelMultiplier = AfterDiveTerminalVelocityCurve->GetFloatValue(GetWorld()->GetTimeSeconds() - DiveStopTime);
+			const float TerminalVelMultiplier = HiltCurves::Evaluate(AfterDiveTerminalVelocityCurve, UHiltSimulationSubsystem::GetGameplayTime(this) - DiveStopTime);
 
 			//multiply the terminal limit by the value
 			TerminalLimit *= TerminalVelMultiplier;
@@ -474,13 +748,13 @@ FVector UPlayerMovementComponent::NewFallVelocity(const FVector& InitialVelocity
 	if (bIsSpeedLimited && !IsDiving())
 	{
 		//get the fall speed limit from the score component
-		const float FallSpeedLimit = PlayerPawn->ScoreComponent->GetCurrentScoreValues().FallSpeedLimit;
+		const float FallSpeedLimit = PlayerPawn->ScoreComponent->GetScoreValues().FallSpeedLimit;
 
 		//add in the after dive terminal velocity curve
 		if (AfterDiveTerminalVelocityCurve->IsValidLowLevelFast())
 		{
 			//get the value from the curve
-			const float Value = AfterDiveTerminalVelocityCurve->GetFloatValue(GetWorld()->GetTimeSeconds() - DiveStopTime);
+			const float Value = HiltCurves::Evaluate(AfterDiveTerminalVelocityCurve, UHiltSimulationSubsystem::GetGameplayTime(this) - DiveStopTime);
 
 			//clamp the result to the terminal limit multiplied by the value
 			return Result.GetClampedToMaxSize(FallSpeedLimit * Value);
@@ -539,14 +813,11 @@ FVector UPlayerMovementComponent::GetAirControl(float DeltaTime, float TickAirCo
 	//store the result
 	FVector Result = Super::GetAirControl(DeltaTime, TickAirControl, FallAcceleration);
 
-	//check if we're diving anc we have a valid DiveWasdCurve
-	if (IsDiving() && DiveWasdCurve->IsValidLowLevelFast())
+	//check if we're diving
+	if (IsDiving())
 	{
-		//get the value from the curve
-		const float DiveWasdValue = DiveWasdCurve->GetFloatValue(GetWorld()->GetTimeSeconds() - DiveStartTime);
-
-		//multiply the result by the value
-		Result *= DiveWasdValue;
+		//multiply the result by this frame's dive air control multiplier
+		Result *= DiveParams.AirControlMultiplier;
 	}
 
 	//return the result
@@ -565,7 +836,7 @@ void UPlayerMovementComponent::StartFalling(int32 Iterations, float remainingTim
 		bIsSlideFalling = true;
 
 		//set the slide fall start time
-		SlideFallStartTime = GetWorld()->GetTimeSeconds();
+		SlideFallStartTime = UHiltSimulationSubsystem::GetGameplayTime(this);
 
 		//stop sliding
 		StopSlide();
@@ -614,7 +885,14 @@ float UPlayerMovementComponent::GetMaxBrakingDeceleration() const
 	if (IsFalling() && Velocity.Z < 0 && !bMightBeBunnyJumping)
 	{
 		//return the value of the falling braking friction curve
-		return FallingBrakingDecelerationCurve->GetFloatValue(FMath::Abs(Velocity.Z) / GetMaxSpeed());
+		return HiltCurves::Evaluate(FallingBrakingDecelerationCurve, FMath::Abs(Velocity.Z) / GetMaxSpeed());
+	}
+
+	//check if we're diving (the parent implementation returns 0 for custom movement modes)
+	if (IsDiving())
+	{
+		//brake like falling
+		return BrakingDecelerationFalling;
 	}
 
 	//default to the parent implementation
@@ -627,7 +905,7 @@ void UPlayerMovementComponent::ApplyVelocityBraking(float DeltaTime, float Frict
 	if ((!IsSliding() && IsWalking()) || bMightBeBunnyJumping && IsFalling())
 	{
 		//set the friction to the value of the sliding friction
-		Friction = WalkingBrakingFrictionCurve->GetFloatValue(Velocity.Size() / GetMaxSpeed());
+		Friction = HiltCurves::Evaluate(WalkingBrakingFrictionCurve, Velocity.Size() / GetMaxSpeed());
 	}
 	//check if we're sliding and walking
 	else if (IsSliding())
@@ -645,8 +923,8 @@ void UPlayerMovementComponent::CalcVelocity(float DeltaTime, float Friction, boo
 	//check if we're sliding and walking and we're not brake sliding
 	if (IsSliding())
 	{
-		//set the friction to the value of the sliding friction
-		Friction = SlidingGroundFrictionCurve->GetFloatValue(Velocity.Size() / GetMaxSpeed());
+		//use this frame's slide friction
+		Friction = SlideParams.GroundFriction;
 	}
 
 	//check if we're falling and grappling
@@ -703,9 +981,9 @@ float UPlayerMovementComponent::GetAxisDeltaRotation(float InAxisRotationRate, f
 FRotator UPlayerMovementComponent::GetDeltaRotation(float DeltaTime) const
 {
 	//check if we're sliding and walking
-	if (IsSliding() && PlayerPawn->ScoreComponent->GetCurrentScoreValues().SlidingTurnRateCurve->IsValidLowLevelFast())
+	if (IsSliding() && PlayerPawn->ScoreComponent->GetScoreValues().SlidingTurnRateCurve->IsValidLowLevelFast())
 	{
-		return FRotator(GetAxisDeltaRotation(0, DeltaTime), GetAxisDeltaRotation(PlayerPawn->ScoreComponent->GetCurrentScoreValues().SlidingTurnRateCurve->GetFloatValue(Velocity.Size() / FMath::Max(GetMaxSpeed(), GetCurrentSpeedLimit())), DeltaTime), GetAxisDeltaRotation(0, DeltaTime));
+		return FRotator(GetAxisDeltaRotation(0, DeltaTime), GetAxisDeltaRotation(HiltCurves::Evaluate(PlayerPawn->ScoreComponent->GetScoreValues().SlidingTurnRateCurve, Velocity.Size() / FMath::Max(GetMaxSpeed(), GetCurrentSpeedLimit())), DeltaTime), GetAxisDeltaRotation(0, DeltaTime));
 	}
 
 	//default to the parent implementation
@@ -738,7 +1016,7 @@ float UPlayerMovementComponent::GetMaxSpeed() const
 	if (IsFalling())
 	{
 		//storage for the max speed to use
-		float MaxSpeedToUse = MaxFallSpeed * PlayerPawn->ScoreComponent->GetCurrentScoreValues().FallSpeedMultiplier;
+		float MaxSpeedToUse = MaxFallSpeed * PlayerPawn->ScoreComponent->GetScoreValues().FallSpeedMultiplier;
 
 		//check if we might be bunny jumping
 		if (bMightBeBunnyJumping)
@@ -753,14 +1031,11 @@ float UPlayerMovementComponent::GetMaxSpeed() const
 			return FMath::Min(MaxSpeedToUse, GetCurrentSpeedLimit());
 		}
 
-		//check if we're diving and we have a valid DiveMaxWasdSpeedCurve curve
-		if (IsDiving() && DiveMaxWasdSpeedCurve->IsValidLowLevelFast())
+		//check if we're diving
+		if (IsDiving())
 		{
-			//get the value
-			const float Value = DiveMaxWasdSpeedCurve->GetFloatValue(GetWorld()->GetTimeSeconds() - DiveStartTime);
-
-			//multiply in the value
-			MaxSpeedToUse *= Value;
+			//multiply in this frame's dive max speed multiplier
+			MaxSpeedToUse *= DiveParams.MaxSpeedMultiplier;
 		}
 
 		//return the max fall speed
@@ -805,8 +1080,11 @@ void UPlayerMovementComponent::HandleImpact(const FHitResult& Hit, float TimeSli
 		//rotate the character to the floor
 		GetCharacterOwner()->SetActorRotation(FRotationMatrix::MakeFromX(Hit.Normal).Rotator());
 
-		//set the movement mode to walking
-		SetMovementMode(MOVE_Walking);
+		//set the movement mode to walking (unless we're already on the ground, so a slide stays in the slide movement mode)
+		if (!IsMovingOnGround())
+		{
+			SetMovementMode(MOVE_Walking);
+		}
 
 		//check if we're not using normal movement
 		if (PlayerPawn->GrappleComponent->bIsGrappling && !PlayerPawn->GrappleComponent->ShouldUseNormalMovement())
@@ -852,7 +1130,7 @@ void UPlayerMovementComponent::HandleImpact(const FHitResult& Hit, float TimeSli
 		const float InvertedDotProduct = FMath::GetMappedRangeValueClamped(FVector2D(-1, 1), FVector2D(0, 1), DotProduct);
 
 		//calculate the launch velocity
-		FVector UnclampedLaunchVelocity = (Hit.ImpactNormal + Velocity.GetSafeNormal() * InvertedDotProduct).GetSafeNormal() * CollisionLaunchSpeedCurve->GetFloatValue(Velocity.Size() / GetMaxSpeed());
+		FVector UnclampedLaunchVelocity = (Hit.ImpactNormal + Velocity.GetSafeNormal() * InvertedDotProduct).GetSafeNormal() * HiltCurves::Evaluate(CollisionLaunchSpeedCurve, Velocity.Size() / GetMaxSpeed());
 
 		//check if we're sliding
 		if (IsSliding())
@@ -861,7 +1139,7 @@ void UPlayerMovementComponent::HandleImpact(const FHitResult& Hit, float TimeSli
 			UnclampedLaunchVelocity += FVector::UpVector * SlideCollisionLaunchExtraForce;
 
 			//set the start time of the slide
-			SlideStartTime = GetWorld()->GetTimeSeconds();
+			SlideStartTime = UHiltSimulationSubsystem::GetGameplayTime(this);
 		}
 
 		//check if we're grappling and not using normal movement
@@ -909,10 +1187,10 @@ void UPlayerMovementComponent::ApplyImpactPhysicsForces(const FHitResult& Impact
 			const float DotProduct = FVector::DotProduct(Velocity.GetSafeNormal(), Impact.ImpactNormal);
 
 			//add in the slide landing dot curve to the velocity
-			Velocity *= SlideLandingDotCurve->GetFloatValue(DotProduct);
+			Velocity *= HiltCurves::Evaluate(SlideLandingDotCurve, DotProduct);
 
 			//add in the slide landing dot curve to the current slide speed
-			CurrentSlideSpeed *= SlideLandingDotCurve->GetFloatValue(DotProduct);
+			CurrentSlideSpeed *= HiltCurves::Evaluate(SlideLandingDotCurve, DotProduct);
 		}
 	}
 	else
@@ -940,6 +1218,41 @@ void UPlayerMovementComponent::ProcessLanded(const FHitResult& Hit, float remain
 	PlayerPawn->ScoreComponent->StartDegredationTimer();
 }
 
+void UPlayerMovementComponent::SetPostLandedPhysics(const FHitResult& Hit)
+{
+	//call the parent implementation
+	Super::SetPostLandedPhysics(Hit);
+
+	//check if we didn't land on the ground
+	if (!IsMovingOnGround())
+	{
+		return;
+	}
+
+	//check if slide is held, was pressed just before landing or was started in the air (by diving into a wall)
+	if (bWantsToSlide || bIsSliding || BufferedSlideTimeRemaining > 0)
+	{
+		//start sliding on the substep we landed on (so a buffered jump below becomes a slide jump)
+		BufferedSlideTimeRemaining = 0;
+		StartSlide();
+	}
+
+	//check if jump was pressed just before landing
+	if (BufferedJumpTimeRemaining > 0 && CharacterOwner->CanJump())
+	{
+		//jump on the substep we landed on, the rest of the frame is simulated in the air
+		BufferedJumpTimeRemaining = 0;
+		if (DoJump(CharacterOwner->bClientUpdating))
+		{
+			//do what ACharacter::CheckJumpInput does after a jump (counts it, starts the jump hold time and calls the jump events)
+			++CharacterOwner->JumpCurrentCount;
+			CharacterOwner->JumpForceTimeRemaining = CharacterOwner->GetJumpMaxHoldTime();
+			CharacterOwner->bWasJumping = true;
+			CharacterOwner->OnJumped();
+		}
+	}
+}
+
 bool UPlayerMovementComponent::DoJump(bool bReplayingMoves)
 {
 	//check if we're moving fast enough to do a boosted jump and we're on the ground and that this isn't a double jump
@@ -984,14 +1297,14 @@ bool UPlayerMovementComponent::DoJump(bool bReplayingMoves)
 		if (SlideJumpSpeedCurve->IsValidLowLevelFast())
 		{
 			//get the super jump force
-			SlideJumpForce *= SlideJumpSpeedCurve->GetFloatValue(Velocity.Size() / GetMaxSpeed());
+			SlideJumpForce *= HiltCurves::Evaluate(SlideJumpSpeedCurve, Velocity.Size() / GetMaxSpeed());
 		}
 
 		//check if we have a valid slide jump direction curve
 		if (SlideJumpDirectionCurve->IsValidLowLevelFast())
 		{
 			//get the super jump direction
-			SlideJumpForce *= SlideJumpDirectionCurve->GetFloatValue(FVector::DotProduct(LastSuperJumpDirection.GetSafeNormal(), Velocity.GetSafeNormal()));
+			SlideJumpForce *= HiltCurves::Evaluate(SlideJumpDirectionCurve, FVector::DotProduct(LastSuperJumpDirection.GetSafeNormal(), Velocity.GetSafeNormal()));
 		}
 
 		//launch the character in the direction of the jump
@@ -1003,18 +1316,15 @@ bool UPlayerMovementComponent::DoJump(bool bReplayingMoves)
 		//set the gravity scale to 0
 		GravityScale = 0;
 
-		//throwaway timer handle
-		FTimerHandle SlideJumpGravityResetTimer;
+		//start counting down the slide jump time (ended in UpdateCharacterStateBeforeMovement)
+		SlideJumpTimeRemaining = SlideJumpTime;
 
-		//use timer manager lamba to reset the slide jump variable
-		GetWorld()->GetTimerManager().SetTimer(SlideJumpGravityResetTimer, [this]
+		//check if this isn't a replayed move
+		if (!bReplayingMoves)
 		{
-			bIsSlideJumping = false;
-			GravityScale = DefaultGravityScale;
-		}, SlideJumpTime, false);
-
-		//call the blueprint event
-		OnPlayerSLideJump.Broadcast();
+			//call the blueprint event
+			OnPlayerSLideJump.Broadcast();
+		}
 
 		//stop sliding
 		StopSlide();
@@ -1023,9 +1333,238 @@ bool UPlayerMovementComponent::DoJump(bool bReplayingMoves)
 		return true;
 	}
 
-	//call the blueprint event for a normal jump
-	OnPlayerNormalJump.Broadcast();	
+	//check if this isn't a replayed move
+	if (!bReplayingMoves)
+	{
+		//call the blueprint event for a normal jump
+		OnPlayerNormalJump.Broadcast();
+	}
 
 	//default to the parent implementation
 	return Super::DoJump(bReplayingMoves);
 }
+
+void UPlayerMovementComponent::UpdateFromCompressedFlags(const uint8 Flags)
+{
+	//call the parent implementation
+	Super::UpdateFromCompressedFlags(Flags);
+
+	//get the slide input
+	bWantsToSlide = (Flags & FSavedMove_Player::FLAG_WantsToSlide) != 0;
+
+	//check if the client already ended its slide jump (the server never starts one from the flags, only from replaying the jump)
+	if (bIsSlideJumping && (Flags & FSavedMove_Player::FLAG_SlideJumping) == 0)
+	{
+		//end the slide jump
+		EndSlideJump();
+	}
+}
+
+void UPlayerMovementComponent::UpdateCharacterStateBeforeMovement(const float DeltaSeconds)
+{
+	//call the parent implementation
+	Super::UpdateCharacterStateBeforeMovement(DeltaSeconds);
+
+	//check if the slide button is held
+	if (bWantsToSlide)
+	{
+		//check if we're in the air
+		if (IsFalling())
+		{
+			//start the dive
+			StartDive();
+		}
+		else
+		{
+			//start (or keep) sliding
+			StartSlide();
+		}
+	}
+	else
+	{
+		//check if we're diving
+		if (bIsDiving)
+		{
+			//stop diving
+			StopDive();
+		}
+
+		//check if we're sliding
+		if (bIsSliding)
+		{
+			//stop sliding
+			StopSlide();
+		}
+	}
+
+	//update the buffered presses
+	UpdateInputBuffer(DeltaSeconds);
+
+	//check if the slide jump time is counting down
+	if (SlideJumpTimeRemaining > 0)
+	{
+		//count down the slide jump time
+		SlideJumpTimeRemaining -= DeltaSeconds;
+
+		//check if the slide jump time is up
+		if (SlideJumpTimeRemaining <= 0)
+		{
+			//end the slide jump
+			EndSlideJump();
+		}
+	}
+}
+
+FNetworkPredictionData_Client* UPlayerMovementComponent::GetPredictionData_Client() const
+{
+	//check if the prediction data hasn't been created yet
+	if (!ClientPredictionData)
+	{
+		//create our prediction data (so our saved moves are used)
+		UPlayerMovementComponent* MutableThis = const_cast<UPlayerMovementComponent*>(this);
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_Player(*this);
+	}
+
+	return ClientPredictionData;
+}
+
+bool UPlayerMovementComponent::IsReplayingMoves() const
+{
+	return CharacterOwner && CharacterOwner->bClientUpdating;
+}
+
+void UPlayerMovementComponent::UpdateInputBuffer(const float DeltaSeconds)
+{
+	//count down the buffered presses
+	BufferedJumpTimeRemaining = FMath::Max(BufferedJumpTimeRemaining - DeltaSeconds, 0.f);
+	BufferedSlideTimeRemaining = FMath::Max(BufferedSlideTimeRemaining - DeltaSeconds, 0.f);
+
+	//check if we're not in the air (presses on the ground are handled right away)
+	if (!IsFalling())
+	{
+		return;
+	}
+
+	//check if jump is pressed in the air without it having made us jump
+	if (CharacterOwner->bPressedJump && !CharacterOwner->bWasJumping)
+	{
+		//buffer the jump
+		BufferedJumpTimeRemaining = InputBufferWindow;
+	}
+
+	//check if slide is held in the air
+	if (bWantsToSlide)
+	{
+		//buffer the slide
+		BufferedSlideTimeRemaining = InputBufferWindow;
+	}
+}
+
+void UPlayerMovementComponent::EndSlideJump()
+{
+	//stop the slide jump and restore gravity
+	bIsSlideJumping = false;
+	SlideJumpTimeRemaining = 0;
+	GravityScale = DefaultGravityScale;
+}
+
+void FSavedMove_Player::Clear()
+{
+	//call the parent implementation
+	FSavedMove_Character::Clear();
+
+	//reset the saved values
+	bSavedWantsToSlide = false;
+	bSavedIsSliding = false;
+	bSavedIsDiving = false;
+	bSavedIsSlideJumping = false;
+	SavedCurrentSlideSpeed = 0;
+	SavedSlideJumpTimeRemaining = 0;
+	SavedGravityScale = 1;
+	SavedBufferedJumpTimeRemaining = 0;
+	SavedBufferedSlideTimeRemaining = 0;
+}
+
+uint8 FSavedMove_Player::GetCompressedFlags() const
+{
+	//get the parent flags
+	uint8 Flags = FSavedMove_Character::GetCompressedFlags();
+
+	//add the slide input
+	if (bSavedWantsToSlide)
+	{
+		Flags |= FLAG_WantsToSlide;
+	}
+
+	//add the slide jump state
+	if (bSavedIsSlideJumping)
+	{
+		Flags |= FLAG_SlideJumping;
+	}
+
+	return Flags;
+}
+
+bool FSavedMove_Player::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, const float MaxDelta) const
+{
+	//get the new move as a player move
+	const FSavedMove_Player* NewPlayerMove = static_cast<const FSavedMove_Player*>(NewMove.Get());
+
+	//don't combine moves where the slide input or state changed
+	if (bSavedWantsToSlide != NewPlayerMove->bSavedWantsToSlide || bSavedIsSliding != NewPlayerMove->bSavedIsSliding || bSavedIsDiving != NewPlayerMove->bSavedIsDiving || bSavedIsSlideJumping != NewPlayerMove->bSavedIsSlideJumping)
+	{
+		return false;
+	}
+
+	//call the parent implementation
+	return FSavedMove_Character::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+void FSavedMove_Player::SetMoveFor(ACharacter* C, const float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData)
+{
+	//call the parent implementation
+	FSavedMove_Character::SetMoveFor(C, InDeltaTime, NewAccel, ClientData);
+
+	//get the player movement component
+	const UPlayerMovementComponent* MovementComponent = Cast<UPlayerMovementComponent>(C->GetCharacterMovement());
+
+	//save the slide input and the state at the start of the move
+	bSavedWantsToSlide = MovementComponent->bWantsToSlide;
+	bSavedIsSliding = MovementComponent->bIsSliding;
+	bSavedIsDiving = MovementComponent->bIsDiving;
+	bSavedIsSlideJumping = MovementComponent->bIsSlideJumping;
+	SavedCurrentSlideSpeed = MovementComponent->CurrentSlideSpeed;
+	SavedSlideJumpTimeRemaining = MovementComponent->SlideJumpTimeRemaining;
+	SavedGravityScale = MovementComponent->GravityScale;
+	SavedBufferedJumpTimeRemaining = MovementComponent->BufferedJumpTimeRemaining;
+	SavedBufferedSlideTimeRemaining = MovementComponent->BufferedSlideTimeRemaining;
+}
+
+void FSavedMove_Player::PrepMoveFor(ACharacter* C)
+{
+	//call the parent implementation
+	FSavedMove_Character::PrepMoveFor(C);
+
+	//get the player movement component
+	UPlayerMovementComponent* MovementComponent = Cast<UPlayerMovementComponent>(C->GetCharacterMovement());
+
+	//restore the slide input and the state at the start of the move so the replay integrates the slide speed from the same state
+	MovementComponent->bWantsToSlide = bSavedWantsToSlide;
+	MovementComponent->bIsSliding = bSavedIsSliding;
+	MovementComponent->bIsDiving = bSavedIsDiving;
+	MovementComponent->bIsSlideJumping = bSavedIsSlideJumping;
+	MovementComponent->CurrentSlideSpeed = SavedCurrentSlideSpeed;
+	MovementComponent->SlideJumpTimeRemaining = SavedSlideJumpTimeRemaining;
+	MovementComponent->GravityScale = SavedGravityScale;
+	MovementComponent->BufferedJumpTimeRemaining = SavedBufferedJumpTimeRemaining;
+	MovementComponent->BufferedSlideTimeRemaining = SavedBufferedSlideTimeRemaining;
+}
+
+FNetworkPredictionData_Client_Player::FNetworkPredictionData_Client_Player(const UCharacterMovementComponent& ClientMovement) : FNetworkPredictionData_Client_Character(ClientMovement)
+{
+}
+
+FSavedMovePtr FNetworkPredictionData_Client_Player::AllocateNewMove()
+{
+	return MakeShared<FSavedMove_Player>();
+}
@@ -3,15 +3,15 @@
 #include "Components/RocketLauncherComponent.h"
 
 #include "Components/GrapplingHook/GrapplingComponent.h"
+#include "Core/HiltSimulationSubsystem.h"
 #include "NPC/Components/GrappleableComponent.h"
 #include "Player/PlayerCharacter.h"
 
 URocketLauncherComponent::URocketLauncherComponent()
 {
-	//enable ticking
-	PrimaryComponentTick.bCanEverTick = true;
+	//disable ticking (reloading runs on a timer)
+	PrimaryComponentTick.bCanEverTick = false;
 	bAutoActivate = true;
-	UActorComponent::SetComponentTickEnabled(true);
 
 	//set the default values
 	RocketExplosionClass = nullptr;
@@ -45,17 +45,27 @@ AActor* URocketLauncherComponent::FireProjectile(FVector Direction)
 	}
 
 	//check if the last fire time is less than the reload time
-	if (GetWorld()->GetTimeSeconds() - LastFireTime < LoadTime)
+	if (UHiltSimulationSubsystem::GetGameplayTime(this) - LastFireTime < LoadTime)
 	{
 		//return nullptr
 		return nullptr;
 	}
 
+	//check if the clip was full (the reload time counts from the first rocket fired out of a full clip)
+	if (CurrentAmmo >= ClipSize)
+	{
+		//set the last reload time
+		LastReloadTime = UHiltSimulationSubsystem::GetGameplayTime(this);
+	}
+
 	//decrement the current ammo
 	CurrentAmmo--;
 
 	//set the last fire time
-	LastFireTime = GetWorld()->GetTimeSeconds();
+	LastFireTime = UHiltSimulationSubsystem::GetGameplayTime(this);
+
+	//start reloading the clip
+	StartReloadTimer();
 
 	//spawn and return the projectile
 	return Super::FireProjectile(Direction);
@@ -84,26 +94,32 @@ void URocketLauncherComponent::OnProjectileHit(AActor* Projectile, AActor* Other
 	Super::OnProjectileHit(Projectile, OtherActor, NormalImpulse, Hit);
 }
 
-void URocketLauncherComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+void URocketLauncherComponent::BeginPlay()
 {
 	//call the parent implementation
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	Super::BeginPlay();
 
-	if (bEnableReloading)
-	{
-		//load a rocket into the rocket launcher
-		LoadRocketClip();
-	}
+	//set the current ammo to the starting ammo
+	CurrentAmmo = StartingAmmo;
+
+	//start reloading if we start with less than a full clip
+	StartReloadTimer();
 }
 
-void URocketLauncherComponent::BeginPlay()
+#if WITH_EDITOR
+void URocketLauncherComponent::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
 {
 	//call the parent implementation
-	Super::BeginPlay();
+	Super::PostEditChangeProperty(PropertyChangedEvent);
 
-	//set the current ammo to the starting ammo
-	CurrentAmmo = StartingAmmo;
+	//check if reloading was toggled while playing
+	if (PropertyChangedEvent.GetMemberPropertyName() == GET_MEMBER_NAME_CHECKED(URocketLauncherComponent, bEnableReloading) && HasBegunPlay())
+	{
+		//start or stop the reload timer
+		SetReloadingEnabled(bEnableReloading);
+	}
 }
+#endif
 
 void URocketLauncherComponent::LoadRocketClip()
 {
@@ -111,18 +127,17 @@ void URocketLauncherComponent::LoadRocketClip()
 	if (CurrentAmmo >= ClipSize)
 	{
 		//set the last reload time
-		LastReloadTime = GetWorld()->GetTimeSeconds();
+		LastReloadTime = UHiltSimulationSubsystem::GetGameplayTime(this);
 
 		//prevent further execution
 		return;
 	}
 
-	
 	//the last reload time plus the reload time is less than the current time
 	const float LocReloadTime = LastReloadTime + ReloadTime;
 
 	//check the reload time
-	if (LocReloadTime > GetWorld()->GetTimeSeconds())
+	if (LocReloadTime > UHiltSimulationSubsystem::GetGameplayTime(this))
 	{
 		//prevent further execution
 		return;
@@ -132,7 +147,73 @@ void URocketLauncherComponent::LoadRocketClip()
 	CurrentAmmo++;
 
 	//set the last reload time
-	LastReloadTime = GetWorld()->GetTimeSeconds();
+	LastReloadTime = UHiltSimulationSubsystem::GetGameplayTime(this);
+
+	//keep reloading until the clip is full
+	StartReloadTimer();
+}
+
+void URocketLauncherComponent::StartReloadTimer()
+{
+	//check if reloading is disabled or the clip is full
+	if (!bEnableReloading || CurrentAmmo >= ClipSize)
+	{
+		return;
+	}
+
+	//get the timer subsystem and check if we're already reloading
+	UHiltTimerSubsystem* TimerSubsystem = UHiltTimerSubsystem::Get(this);
+	if (!TimerSubsystem || TimerSubsystem->IsTimerActive(ReloadTimerHandle))
+	{
+		return;
+	}
+
+	//load the next rocket once the reload time is up
+	TimerSubsystem->SetTimer(ReloadTimerHandle, this, &URocketLauncherComponent::OnReloadTimer, ReloadTime);
+}
+
+void URocketLauncherComponent::OnReloadTimer()
+{
+	//check if reloading was disabled while the timer was running
+	if (!bEnableReloading)
+	{
+		//don't load a rocket or keep the timer going
+		return;
+	}
+
+	//check if the clip isn't full
+	if (CurrentAmmo < ClipSize)
+	{
+		//load a rocket (the timer already waited the reload time)
+		CurrentAmmo++;
+
+		//set the last reload time
+		LastReloadTime = UHiltSimulationSubsystem::GetGameplayTime(this);
+	}
+
+	//keep the timer going until the clip is full
+	StartReloadTimer();
+}
+
+void URocketLauncherComponent::SetReloadingEnabled(const bool bEnabled)
+{
+	//set whether reloading is enabled
+	bEnableReloading = bEnabled;
+
+	//check if reloading was disabled
+	if (!bEnableReloading)
+	{
+		//stop the reload timer
+		if (UHiltTimerSubsystem* TimerSubsystem = UHiltTimerSubsystem::Get(this))
+		{
+			TimerSubsystem->ClearTimer(ReloadTimerHandle);
+		}
+
+		return;
+	}
+
+	//start reloading if the clip isn't full
+	StartReloadTimer();
 }
 
 void URocketLauncherComponent::ResetRocketLauncher()
@@ -145,4 +226,11 @@ void URocketLauncherComponent::ResetRocketLauncher()
 
 	//set the last reload time to 0
 	LastReloadTime = 0.f;
+
+	//restart reloading from the new ammo count
+	if (UHiltTimerSubsystem* TimerSubsystem = UHiltTimerSubsystem::Get(this))
+	{
+		TimerSubsystem->ClearTimer(ReloadTimerHandle);
+	}
+	StartReloadTimer();
 }
@@ -23,8 +23,11 @@ AActor* UTerrainGunComponent::FireProjectile(FVector Direction)
 	//bind the function to the delegate
 	TimerDelegate.BindUFunction(this, GET_FUNCTION_NAME_CHECKED(UTerrainGunComponent, OnProjectileExpired), SpawnedProjectile);
 
-	//bind the timer delegate to the timer handle
-	GetWorld()->GetTimerManager().SetTimer(TerrainTimerHandle, TimerDelegate, ProjectileLifeTime, false);
+	//set the timer (cancelled on restart since the projectiles are destroyed)
+	if (UHiltTimerSubsystem* TimerSubsystem = UHiltTimerSubsystem::Get(this))
+	{
+		TimerSubsystem->SetTimer(TerrainTimerHandle, TimerDelegate, ProjectileLifeTime, false, HiltTimer_CancelOnRestart);
+	}
 
 	//return the spawned projectile
 	return SpawnedProjectile;
@@ -13,6 +13,7 @@
 #include "SocketSubsystem.h"
 #include "Components/RocketLauncherComponent.h"
 #include "Components/GrapplingHook/GrapplingComponent.h"
+#include "Components/PlayerMovementComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Kismet/GameplayStatics.h"
 #include "Player/PlayerCharacter.h"
@@ -161,9 +162,18 @@ void AHiltGameModeBase::RestartLevel()
 							// Player variables
 							PlayerCharacter->GetCharacterMovement()->Velocity = FVector::ZeroVector;
 							PlayerCharacter->RocketLauncherComponent->ResetRocketLauncher();
+
+							//check if the player is sliding
+							if (PlayerCharacter->PlayerMovementComponent->bIsSliding)
+							{
+								//stop sliding
+								PlayerCharacter->PlayerMovementComponent->StopSlide();
+							}
+
 							PlayerCharacter->ScoreComponent->ResetScore();
 							PlayerCharacter->GrappleComponent->StopGrapple(false);
 							PlayerCharacter->hasStartedMoving = false;
+							PlayerCharacter->ResetRewindHistory();
 
 							//array for projectile actors
 							TArray<AActor*> ProjectileActors;
@@ -186,10 +196,19 @@ void AHiltGameModeBase::RestartLevel()
 
 							// Player variables
 							PlayerCharacter->GetCharacterMovement()->Velocity = FVector::ZeroVector;
-							PlayerCharacter->RocketLauncherComponent->CurrentAmmo = PlayerCharacter->RocketLauncherComponent->StartingAmmo;
+							PlayerCharacter->RocketLauncherComponent->ResetRocketLauncher();
+
+							//check if the player is sliding
+							if (PlayerCharacter->PlayerMovementComponent->bIsSliding)
+							{
+								//stop sliding
+								PlayerCharacter->PlayerMovementComponent->StopSlide();
+							}
+
 							PlayerCharacter->ScoreComponent->ResetScore();
 							PlayerCharacter->GrappleComponent->StopGrapple(false);
 							PlayerCharacter->hasStartedMoving = false;
+							PlayerCharacter->ResetRewindHistory();
 
 							//array for projectile actors
 							TArray<AActor*> ProjectileActors;
@@ -219,7 +238,13 @@ void AHiltGameModeBase::RestartLevel()
 	//}
 
 	OnRestartLevelCustom();
-	GetWorld()->GetTimerManager().SetTimer(RestartCooldownHandler, this, &AHiltGameModeBase::RestartCooldownComplete, RestartCooldown, false);
+
+	// Cancel the gameplay timers of the last run and start the restart cooldown
+	if (UHiltTimerSubsystem* TimerSubsystem = UHiltTimerSubsystem::Get(this))
+	{
+		TimerSubsystem->CancelTimers(HiltTimer_CancelOnRestart);
+		TimerSubsystem->SetTimer(RestartCooldownHandler, this, &AHiltGameModeBase::RestartCooldownComplete, RestartCooldown);
+	}
 
 	DoObjectivesOnce = true;
 	canRestart = false;
@@ -0,0 +1,95 @@
+#include "Core/HiltProfiling.h"
+
+int32 HiltProfiling::SceneQueries = 0;
+int32 HiltProfiling::Allocations = 0;
+
+namespace
+{
+	//allocator that counts the game thread's allocations and forwards everything to the allocator it wraps
+	class FCountingMalloc final : public FMalloc
+	{
+	public:
+
+		//the allocator we forward to
+		FMalloc* Inner = nullptr;
+
+		virtual void* Malloc(const SIZE_T Size, const uint32 Alignment) override
+		{
+			CountAllocation();
+			return Inner->Malloc(Size, Alignment);
+		}
+
+		virtual void* TryMalloc(const SIZE_T Size, const uint32 Alignment) override
+		{
+			CountAllocation();
+			return Inner->TryMalloc(Size, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, const SIZE_T Size, const uint32 Alignment) override
+		{
+			//a realloc to zero bytes is a free
+			if (Size > 0)
+			{
+				CountAllocation();
+			}
+			return Inner->Realloc(Original, Size, Alignment);
+		}
+
+		virtual void* TryRealloc(void* Original, const SIZE_T Size, const uint32 Alignment) override
+		{
+			//a realloc to zero bytes is a free
+			if (Size > 0)
+			{
+				CountAllocation();
+			}
+			return Inner->TryRealloc(Original, Size, Alignment);
+		}
+
+		virtual void Free(void* Original) override { Inner->Free(Original); }
+		virtual SIZE_T QuantizeSize(const SIZE_T Count, const uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim(const bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+		virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+		virtual const TCHAR* GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+
+	private:
+
+		//function to count an allocation if it was made on the game thread (other threads keep allocating while we're installed)
+		static void CountAllocation()
+		{
+			if (IsInGameThread())
+			{
+				++HiltProfiling::Allocations;
+			}
+		}
+	};
+
+	//the counting allocator (never destroyed, other threads can still be inside it after it's uninstalled)
+	FCountingMalloc CountingMalloc;
+}
+
+void HiltProfiling::ResetCounters()
+{
+	SceneQueries = 0;
+	Allocations = 0;
+}
+
+HiltProfiling::FScopedAllocationCounter::FScopedAllocationCounter()
+{
+	//check that we're not already installed
+	check(GMalloc != &CountingMalloc);
+
+	//install the counting allocator in front of the current one
+	PreviousMalloc = GMalloc;
+	CountingMalloc.Inner = PreviousMalloc;
+	GMalloc = &CountingMalloc;
+}
+
+HiltProfiling::FScopedAllocationCounter::~FScopedAllocationCounter()
+{
+	//put the previous allocator back (memory allocated through us was allocated by it, so it can still free it)
+	GMalloc = PreviousMalloc;
+}
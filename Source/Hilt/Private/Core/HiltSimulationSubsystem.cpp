@@ -0,0 +1,427 @@
+#include "Core/HiltSimulationSubsystem.h"
+
+#include "Camera/PlayerCameraManager.h"
+#include "Components/PlayerMovementComponent.h"
+#include "Components/Camera/CameraArmComponent.h"
+#include "Components/Camera/PlayerCameraComponent.h"
+#include "Components/RocketLauncherComponent.h"
+#include "Components/GrapplingHook/GrapplingComponent.h"
+#include "Components/GrapplingHook/RopeComponent.h"
+#include "Core/HiltTimerSubsystem.h"
+#include "Misc/FileHelper.h"
+#include "Player/PlayerCharacter.h"
+#include "Player/ScoreComponent.h"
+
+namespace
+{
+	//the step rate of the fixed-step mode (read when a world starts)
+	TAutoConsoleVariable<int32> CVarFixedStepRate(TEXT("Hilt.Sim.FixedStepRate"), 0, TEXT("The step rate of the deterministic fixed-step simulation mode (0 = disabled), read when a world starts"));
+
+	//the buttons that are only set on the step they were pressed
+	constexpr uint8 PressedButtons = HiltInput_Grapple | HiltInput_StopGrapple | HiltInput_Fire;
+
+	//the number of steps per frame when replaying as fast as possible
+	constexpr int32 FastReplayStepsPerFrame = 256;
+
+	//console command to save the recorded input frames of the world
+	FAutoConsoleCommandWithWorldAndArgs SaveRecordingCommand(TEXT("Hilt.Sim.SaveRecording"), TEXT("Saves the recorded fixed-step input frames of the world to a file: Hilt.Sim.SaveRecording <file>"), FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, const UWorld* World)
+	{
+		//check if we have a file and a simulation subsystem
+		const UHiltSimulationSubsystem* Simulation = World ? World->GetSubsystem<UHiltSimulationSubsystem>() : nullptr;
+		if (Args.IsEmpty() || !Simulation)
+		{
+			return;
+		}
+
+		//save the recording
+		Simulation->SaveRecording(Args[0]);
+	}));
+}
+
+double UHiltSimulationSubsystem::GetGameplayTime(const UObject* WorldContextObject)
+{
+	//get the world
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	if (!World)
+	{
+		return 0;
+	}
+
+	//use the step time in fixed-step mode and the world time otherwise
+	const UHiltSimulationSubsystem* Simulation = World->GetSubsystem<UHiltSimulationSubsystem>();
+	return Simulation && Simulation->IsFixedStep() ? Simulation->GetStepTime() : World->GetTimeSeconds();
+}
+
+void UHiltSimulationSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	//call the parent implementation
+	Super::Initialize(Collection);
+
+	//get the step rate
+	int32 StepRate = CVarFixedStepRate.GetValueOnGameThread();
+	FParse::Value(FCommandLine::Get(), TEXT("HiltFixedStep="), StepRate);
+
+	//check if we should replay a recording
+	if (FString ReplayPath; FParse::Value(FCommandLine::Get(), TEXT("HiltReplay="), ReplayPath))
+	{
+		//load the recording
+		if (LoadRecordingFile(ReplayPath, ReplayHeader, ReplayFrames))
+		{
+			//replay it at the rate it was recorded at
+			bReplaying = true;
+			StepRate = ReplayHeader.StepRate;
+			bReplayFast = FParse::Param(FCommandLine::Get(), TEXT("HiltReplayFast"));
+			bExitAfterReplay = FParse::Param(FCommandLine::Get(), TEXT("HiltReplayExit"));
+		}
+		else
+		{
+			UE_LOG(LogTemp, Error, TEXT("HiltSimulation: failed to load the recording %s"), *ReplayPath);
+		}
+	}
+
+	//check if we should record
+	if (FParse::Value(FCommandLine::Get(), TEXT("HiltRecord="), RecordingPath))
+	{
+		//recording needs the fixed-step mode
+		bRecording = true;
+		StepRate = StepRate > 0 ? StepRate : 120;
+	}
+
+	//set the fixed time step
+	FixedTimeStep = StepRate > 0 ? 1.0 / StepRate : 0;
+	RecordingHeader.StepRate = FMath::Max(StepRate, 0);
+}
+
+void UHiltSimulationSubsystem::Deinitialize()
+{
+	//check if we recorded anything
+	if (bRecording && !RecordedFrames.IsEmpty())
+	{
+		//save the recording
+		SaveRecording(RecordingPath);
+	}
+
+	//call the parent implementation
+	Super::Deinitialize();
+}
+
+bool UHiltSimulationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UHiltSimulationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHiltSimulationSubsystem, STATGROUP_Tickables);
+}
+
+bool UHiltSimulationSubsystem::IsTickable() const
+{
+	return IsFixedStep() && SimulatedPlayer.IsValid();
+}
+
+void UHiltSimulationSubsystem::RegisterPlayer(APlayerCharacter* Player)
+{
+	//check if we're not in fixed-step mode or already have a player
+	if (!IsFixedStep() || SimulatedPlayer.IsValid())
+	{
+		return;
+	}
+
+	//set the simulated player
+	SimulatedPlayer = Player;
+
+	//the components are stepped by us from now on
+	DisableComponentTicks(Player);
+
+	//use the synchronous paths of the queries that are answered a frame late, their results depend on the frame rate
+	Player->PlayerMovementComponent->bSyncBunnyJumpProbe = true;
+	Player->GrappleComponent->bUseSameFrameGrapple = false;
+
+	//keep rendering the rope while its tick is disabled
+	Player->RopeComponent->bSteppedBySimulation = true;
+
+	//check if we're replaying
+	if (bReplaying)
+	{
+		//start the player where the recording started
+		Player->SetActorLocationAndRotation(FVector(ReplayHeader.StartLocation), FRotator(ReplayHeader.StartRotation), false, nullptr, ETeleportType::ResetPhysics);
+		ReplayStartTime = FPlatformTime::Seconds();
+	}
+
+	//store where the recording starts
+	RecordingHeader.StartLocation = FVector3f(Player->GetActorLocation());
+	RecordingHeader.StartRotation = FRotator3f(Player->GetActorRotation());
+
+	//print the mode
+	UE_LOG(LogTemp, Display, TEXT("HiltSimulation: fixed-step mode at %.0f steps per second%s%s"), 1.0 / FixedTimeStep, bRecording ? TEXT(", recording") : TEXT(""), bReplaying ? TEXT(", replaying") : TEXT(""));
+}
+
+bool UHiltSimulationSubsystem::QueueButtons(const uint8 Buttons)
+{
+	//check if we're not in fixed-step mode
+	if (!IsFixedStep() || !SimulatedPlayer.IsValid())
+	{
+		return false;
+	}
+
+	//queue the buttons for the next step (ignored when replaying, the recording has its own)
+	QueuedButtons |= Buttons;
+	return true;
+}
+
+void UHiltSimulationSubsystem::Tick(const float DeltaTime)
+{
+	//call the parent implementation
+	Super::Tick(DeltaTime);
+
+	//get the player
+	APlayerCharacter* Player = SimulatedPlayer.Get();
+
+	//check if we're not replaying
+	if (!bReplaying)
+	{
+		//capture the live input of this frame
+		CaptureLiveFrame(Player);
+	}
+
+	//get the number of steps to simulate this frame
+	int32 NumSteps;
+	if (bReplaying && bReplayFast)
+	{
+		//replay as fast as possible
+		NumSteps = FastReplayStepsPerFrame;
+	}
+	else
+	{
+		//add the frame time to the accumulator
+		TimeAccumulator += DeltaTime;
+
+		//get the number of whole steps that passed
+		NumSteps = FMath::Min(FMath::FloorToInt32(TimeAccumulator / FixedTimeStep), MaxStepsPerFrame);
+		TimeAccumulator -= NumSteps * FixedTimeStep;
+
+		//drop the time we couldn't simulate so a hitch doesn't spiral
+		TimeAccumulator = FMath::Min(TimeAccumulator, FixedTimeStep);
+	}
+
+	//simulate the steps
+	for (int32 Step = 0; Step < NumSteps; ++Step)
+	{
+		//check if we're replaying
+		if (bReplaying)
+		{
+			//check if we've run out of input frames
+			if (ReplayIndex >= ReplayFrames.Num())
+			{
+				FinishReplay();
+				break;
+			}
+
+			//apply the recorded input and simulate the step
+			ApplyInputFrame(Player, ReplayFrames[ReplayIndex], static_cast<float>(FixedTimeStep));
+			StepPlayer(Player);
+
+			//check how far we drifted from the recording
+			MaxReplayDrift = FMath::Max(MaxReplayDrift, FVector3f::Dist(FVector3f(Player->GetActorLocation()), ReplayFrames[ReplayIndex].ResultLocation));
+			++ReplayIndex;
+			continue;
+		}
+
+		//apply the live input and simulate the step
+		ApplyInputFrame(Player, LiveFrame, static_cast<float>(FixedTimeStep));
+		StepPlayer(Player);
+
+		//check if we're recording
+		if (bRecording)
+		{
+			//record the input frame with the location it resulted in
+			FHiltInputFrame& Frame = RecordedFrames.Add_GetRef(LiveFrame);
+			Frame.ResultLocation = FVector3f(Player->GetActorLocation());
+		}
+
+		//the pressed buttons only apply to the first step
+		LiveFrame.Buttons &= ~PressedButtons;
+	}
+}
+
+void UHiltSimulationSubsystem::CaptureLiveFrame(APlayerCharacter* Player)
+{
+	//get the movement input added this frame
+	LiveFrame.MovementInput = FVector3f(Player->ConsumeMovementInputVector());
+	LiveFrame.MoveDirection = FVector2f(Player->CurrentMoveDirection);
+
+	//get the control rotation
+	if (const AController* Controller = Player->GetController())
+	{
+		LiveFrame.ControlRotation = FRotator3f(Controller->GetControlRotation());
+	}
+
+	//get the held buttons and add the pressed buttons (keeping pressed buttons that haven't been stepped yet)
+	uint8 Buttons = (LiveFrame.Buttons & PressedButtons) | QueuedButtons;
+	Buttons |= Player->bPressedJump ? HiltInput_Jump : 0;
+	Buttons |= Player->PlayerMovementComponent->bWantsToSlide ? HiltInput_Slide : 0;
+	LiveFrame.Buttons = Buttons;
+	QueuedButtons = 0;
+}
+
+void UHiltSimulationSubsystem::ApplyInputFrame(APlayerCharacter* Player, const FHiltInputFrame& Frame, const float DeltaTime)
+{
+	//replace the movement input
+	Player->ConsumeMovementInputVector();
+	Player->AddMovementInput(FVector(Frame.MovementInput), 1.f, true);
+	Player->CurrentMoveDirection = FVector2D(Frame.MoveDirection);
+
+	//set the control rotation
+	if (AController* Controller = Player->GetController())
+	{
+		Controller->SetControlRotation(FRotator(Frame.ControlRotation));
+	}
+
+	//update the camera arm and the camera manager, the step aims with the camera (firing, slide jumps and the grapple trace) and a fast replay runs many steps per frame
+	UpdatePlayerView(Player, DeltaTime);
+
+	//check if jump is held
+	if (Frame.Buttons & HiltInput_Jump)
+	{
+		Player->Jump();
+	}
+	else if (Player->bPressedJump)
+	{
+		Player->StopJumping();
+	}
+
+	//set whether or not slide is held
+	Player->PlayerMovementComponent->bWantsToSlide = (Frame.Buttons & HiltInput_Slide) != 0;
+
+	//check if grapple was pressed
+	if ((Frame.Buttons & HiltInput_Grapple) && Player->bCanActivateGrapple)
+	{
+		Player->GrappleComponent->StartGrappleCheck();
+	}
+
+	//check if stop grapple was pressed
+	if (Frame.Buttons & HiltInput_StopGrapple)
+	{
+		Player->GrappleComponent->StopGrapple();
+	}
+
+	//check if fire was pressed
+	if ((Frame.Buttons & HiltInput_Fire) && Player->bCanActivateInput)
+	{
+		Player->RocketLauncherComponent->FireProjectile(Player->Camera->GetForwardVector());
+	}
+}
+
+void UHiltSimulationSubsystem::UpdatePlayerView(APlayerCharacter* Player, const float DeltaTime)
+{
+	//update the camera arm (it follows the control rotation, so the camera's forward vector matches it)
+	Player->CameraArm->TickComponent(DeltaTime, LEVELTICK_All, &Player->CameraArm->PrimaryComponentTick);
+
+	//update the camera manager (the player view point is read from its cached view)
+	if (const APlayerController* PlayerController = Cast<APlayerController>(Player->GetController()); PlayerController && PlayerController->PlayerCameraManager)
+	{
+		PlayerController->PlayerCameraManager->UpdateCamera(DeltaTime);
+	}
+}
+
+void UHiltSimulationSubsystem::StepPlayer(APlayerCharacter* Player)
+{
+	//get the step time
+	const float DeltaTime = static_cast<float>(FixedTimeStep);
+
+	//simulate the components in the order they'd tick in (movement first, then the rope and grapple that read it)
+	Player->PlayerMovementComponent->TickComponent(DeltaTime, LEVELTICK_All, &Player->PlayerMovementComponent->PrimaryComponentTick);
+	Player->RopeComponent->TickComponent(DeltaTime, LEVELTICK_All, &Player->RopeComponent->PrimaryComponentTick);
+	Player->GrappleComponent->TickComponent(DeltaTime, LEVELTICK_All, &Player->GrappleComponent->PrimaryComponentTick);
+	Player->ScoreComponent->TickComponent(DeltaTime, LEVELTICK_All, &Player->ScoreComponent->PrimaryComponentTick);
+
+	//the rope enables its own tick when it's activated
+	DisableComponentTicks(Player);
+
+	//advance the step clock
+	++StepCount;
+
+	//fire the timers that expired this step (so they fire on the same step in a replay however many steps a frame runs)
+	if (UHiltTimerSubsystem* TimerSubsystem = UHiltTimerSubsystem::Get(this))
+	{
+		TimerSubsystem->Dispatch();
+	}
+}
+
+void UHiltSimulationSubsystem::DisableComponentTicks(const APlayerCharacter* Player)
+{
+	//iterate through the stepped components
+	for (UActorComponent* Component : TArray<UActorComponent*, TInlineAllocator<5>>{Player->PlayerMovementComponent, Player->RopeComponent, Player->GrappleComponent, Player->ScoreComponent, Player->CameraArm})
+	{
+		//check if the component is ticking on its own
+		if (Component->IsComponentTickEnabled())
+		{
+			//stop it from ticking
+			Component->SetComponentTickEnabled(false);
+		}
+	}
+}
+
+void UHiltSimulationSubsystem::FinishReplay()
+{
+	//get the time the replay took
+	const double WallTime = FPlatformTime::Seconds() - ReplayStartTime;
+	const double SimulatedTime = ReplayFrames.Num() * FixedTimeStep;
+
+	//print the result
+	UE_LOG(LogTemp, Display, TEXT("HiltSimulation: replayed %d steps (%.2f s) in %.2f s (%.1fx real time), max drift from the recording %.3f"), ReplayFrames.Num(), SimulatedTime, WallTime, SimulatedTime / FMath::Max(WallTime, UE_SMALL_NUMBER), MaxReplayDrift);
+
+	//stop replaying (the live input takes over)
+	bReplaying = false;
+
+	//check if we should quit
+	if (bExitAfterReplay)
+	{
+		FPlatformMisc::RequestExit(false, TEXT("HiltReplay"));
+	}
+}
+
+bool UHiltSimulationSubsystem::SaveRecording(const FString& FilePath) const
+{
+	//set the number of frames
+	FHiltRecordingHeader Header = RecordingHeader;
+	Header.Magic = RecordingMagic;
+	Header.Version = RecordingVersion;
+	Header.NumFrames = RecordedFrames.Num();
+
+	//copy the header and the frames into one buffer
+	TArray<uint8> Bytes;
+	Bytes.SetNumUninitialized(sizeof(FHiltRecordingHeader) + RecordedFrames.Num() * sizeof(FHiltInputFrame));
+	FMemory::Memcpy(Bytes.GetData(), &Header, sizeof(FHiltRecordingHeader));
+	FMemory::Memcpy(Bytes.GetData() + sizeof(FHiltRecordingHeader), RecordedFrames.GetData(), RecordedFrames.Num() * sizeof(FHiltInputFrame));
+
+	//write the file
+	const bool bSaved = FFileHelper::SaveArrayToFile(Bytes, *FilePath);
+	UE_LOG(LogTemp, Display, TEXT("HiltSimulation: %s %d recorded steps to %s"), bSaved ? TEXT("saved") : TEXT("failed to save"), RecordedFrames.Num(), *FilePath);
+
+	return bSaved;
+}
+
+bool UHiltSimulationSubsystem::LoadRecordingFile(const FString& FilePath, FHiltRecordingHeader& OutHeader, TArray<FHiltInputFrame>& OutFrames)
+{
+	//read the file
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *FilePath) || Bytes.Num() < static_cast<int32>(sizeof(FHiltRecordingHeader)))
+	{
+		return false;
+	}
+
+	//read the header and check that it's a recording we can read
+	FMemory::Memcpy(&OutHeader, Bytes.GetData(), sizeof(FHiltRecordingHeader));
+	if (OutHeader.Magic != RecordingMagic || OutHeader.Version != RecordingVersion || OutHeader.StepRate == 0 || static_cast<uint64>(Bytes.Num()) != sizeof(FHiltRecordingHeader) + static_cast<uint64>(OutHeader.NumFrames) * sizeof(FHiltInputFrame))
+	{
+		return false;
+	}
+
+	//read the frames
+	OutFrames.SetNumUninitialized(OutHeader.NumFrames);
+	FMemory::Memcpy(OutFrames.GetData(), Bytes.GetData() + sizeof(FHiltRecordingHeader), OutHeader.NumFrames * sizeof(FHiltInputFrame));
+
+	return true;
+}
@@ -0,0 +1,261 @@
+#include "Core/HiltTimerSubsystem.h"
+
+#include "Core/HiltSimulationSubsystem.h"
+
+namespace
+{
+	//the mask to get the slot of a wheel tick
+	constexpr int64 SlotMask = UHiltTimerSubsystem::NumSlots - 1;
+	static_assert((UHiltTimerSubsystem::NumSlots & SlotMask) == 0, "the number of slots has to be a power of two");
+}
+
+UHiltTimerSubsystem* UHiltTimerSubsystem::Get(const UObject* WorldContextObject)
+{
+	//get the world's timer subsystem
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UHiltTimerSubsystem>() : nullptr;
+}
+
+void UHiltTimerSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	//call the parent implementation
+	Super::Initialize(Collection);
+
+	//empty the slots
+	SlotHeads.Init(INDEX_NONE, NumSlots);
+}
+
+bool UHiltTimerSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UHiltTimerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHiltTimerSubsystem, STATGROUP_Tickables);
+}
+
+void UHiltTimerSubsystem::Tick(const float DeltaTime)
+{
+	//call the parent implementation
+	Super::Tick(DeltaTime);
+
+	//fire the expired timers
+	Dispatch();
+}
+
+void UHiltTimerSubsystem::SetTimer(FHiltTimerHandle& InOutHandle, const FTimerDelegate& Delegate, const float Delay, const bool bLoop, const uint8 Flags)
+{
+	//clear the handle's current timer
+	ClearTimer(InOutHandle);
+
+	//get a free pool entry
+	int32 Index = FirstFree;
+	if (Index != INDEX_NONE)
+	{
+		FirstFree = Timers[Index].Next;
+	}
+	else
+	{
+		Index = Timers.AddDefaulted();
+	}
+
+	//get a serial number (skipping 0, which marks free entries)
+	if (++LastSerial == 0)
+	{
+		++LastSerial;
+	}
+
+	//setup the timer
+	FTimer& Timer = Timers[Index];
+	Timer.Delegate = Delegate;
+	Timer.ExpireTime = UHiltSimulationSubsystem::GetGameplayTime(this) + FMath::Max(Delay, 0.f);
+	Timer.Interval = bLoop ? FMath::Max(Delay, static_cast<float>(TickLength)) : 0;
+	Timer.Serial = LastSerial;
+	Timer.Flags = Flags;
+
+	//add it to the wheel
+	LinkTimer(Index);
+
+	//set the handle
+	InOutHandle.Index = Index;
+	InOutHandle.Serial = LastSerial;
+}
+
+void UHiltTimerSubsystem::ClearTimer(FHiltTimerHandle& InOutHandle)
+{
+	//check if the handle's timer is still active
+	if (FindTimer(InOutHandle))
+	{
+		//remove it
+		FreeTimer(InOutHandle.Index);
+	}
+
+	//invalidate the handle
+	InOutHandle.Invalidate();
+}
+
+bool UHiltTimerSubsystem::IsTimerActive(const FHiltTimerHandle& Handle) const
+{
+	return FindTimer(Handle) != nullptr;
+}
+
+float UHiltTimerSubsystem::GetTimerRemaining(const FHiltTimerHandle& Handle) const
+{
+	//get the handle's timer
+	const FTimer* Timer = FindTimer(Handle);
+	return Timer ? FMath::Max(static_cast<float>(Timer->ExpireTime - UHiltSimulationSubsystem::GetGameplayTime(this)), 0.f) : -1.f;
+}
+
+void UHiltTimerSubsystem::CancelTimers(const uint8 Flags)
+{
+	//iterate through the timer pool
+	for (int32 Index = 0; Index < Timers.Num(); ++Index)
+	{
+		//check if the timer is in use and has any of the flags
+		if (Timers[Index].Serial != 0 && (Timers[Index].Flags & Flags))
+		{
+			//remove it
+			FreeTimer(Index);
+		}
+	}
+}
+
+void UHiltTimerSubsystem::Dispatch()
+{
+	//get the current time and wheel tick
+	const double Now = UHiltSimulationSubsystem::GetGameplayTime(this);
+	const int64 TargetTick = FMath::FloorToInt64(Now / TickLength);
+
+	//check if the clock hasn't moved on to a new tick
+	if (TargetTick <= CurrentTick)
+	{
+		return;
+	}
+
+	//get the first tick to visit (a long frame only needs to visit every slot once)
+	const int64 FirstTick = FMath::Max(CurrentTick + 1, TargetTick - NumSlots + 1);
+
+	//advance the clock before firing anything, so timers set by the callbacks go in later slots
+	CurrentTick = TargetTick;
+
+	//collect the expired timers of the slots the clock moved past
+	ExpiredTimers.Reset();
+	for (int64 Tick = FirstTick; Tick <= TargetTick; ++Tick)
+	{
+		//iterate through the timers of the slot (timers due on a later turn of the wheel stay)
+		for (int32 Index = SlotHeads[Tick & SlotMask]; Index != INDEX_NONE; Index = Timers[Index].Next)
+		{
+			if (Timers[Index].ExpireTick <= TargetTick)
+			{
+				ExpiredTimers.Emplace(Index, Timers[Index].Serial);
+			}
+		}
+	}
+
+	//check if nothing expired
+	if (ExpiredTimers.IsEmpty())
+	{
+		return;
+	}
+
+	//fire them in the order they expired in
+	ExpiredTimers.Sort([this](const TPair<int32, uint32>& A, const TPair<int32, uint32>& B)
+	{
+		return Timers[A.Key].ExpireTime < Timers[B.Key].ExpireTime;
+	});
+
+	//iterate through the expired timers
+	for (const TPair<int32, uint32>& Expired : ExpiredTimers)
+	{
+		//check if an earlier callback cleared or reset the timer
+		if (Timers[Expired.Key].Serial != Expired.Value)
+		{
+			continue;
+		}
+
+		//copy the delegate (the pool can grow while it runs)
+		const FTimerDelegate Delegate = Timers[Expired.Key].Delegate;
+
+		//check if the timer is looping
+		if (FTimer& Timer = Timers[Expired.Key]; Timer.Interval > 0)
+		{
+			//move it to its next expiry (skipping the intervals a long frame jumped over) before firing, so the callback can still clear it
+			UnlinkTimer(Expired.Key);
+			do
+			{
+				Timer.ExpireTime += Timer.Interval;
+			}
+			while (Timer.ExpireTime <= Now);
+			LinkTimer(Expired.Key);
+		}
+		else
+		{
+			//free it before firing, so the callback can set it again
+			FreeTimer(Expired.Key);
+		}
+
+		//fire the timer (skipped if its object has been destroyed)
+		Delegate.ExecuteIfBound();
+	}
+}
+
+const UHiltTimerSubsystem::FTimer* UHiltTimerSubsystem::FindTimer(const FHiltTimerHandle& Handle) const
+{
+	//check if the handle points at a timer with the same serial number
+	return Handle.IsValid() && Timers.IsValidIndex(Handle.Index) && Timers[Handle.Index].Serial == Handle.Serial ? &Timers[Handle.Index] : nullptr;
+}
+
+void UHiltTimerSubsystem::LinkTimer(const int32 Index)
+{
+	//get the tick the timer expires on (never the current one, which has already been dispatched)
+	FTimer& Timer = Timers[Index];
+	Timer.ExpireTick = FMath::Max(FMath::CeilToInt64(Timer.ExpireTime / TickLength), CurrentTick + 1);
+
+	//add it to the front of its slot
+	int32& Head = SlotHeads[Timer.ExpireTick & SlotMask];
+	Timer.Prev = INDEX_NONE;
+	Timer.Next = Head;
+	if (Head != INDEX_NONE)
+	{
+		Timers[Head].Prev = Index;
+	}
+	Head = Index;
+}
+
+void UHiltTimerSubsystem::UnlinkTimer(const int32 Index)
+{
+	//get the timer
+	FTimer& Timer = Timers[Index];
+
+	//point its neighbours (or the slot) past it
+	if (Timer.Prev != INDEX_NONE)
+	{
+		Timers[Timer.Prev].Next = Timer.Next;
+	}
+	else
+	{
+		SlotHeads[Timer.ExpireTick & SlotMask] = Timer.Next;
+	}
+	if (Timer.Next != INDEX_NONE)
+	{
+		Timers[Timer.Next].Prev = Timer.Prev;
+	}
+
+	Timer.Prev = INDEX_NONE;
+	Timer.Next = INDEX_NONE;
+}
+
+void UHiltTimerSubsystem::FreeTimer(const int32 Index)
+{
+	//remove the timer from its slot
+	UnlinkTimer(Index);
+
+	//reset it and add it to the free list
+	FTimer& Timer = Timers[Index];
+	Timer.Delegate.Unbind();
+	Timer.Serial = 0;
+	Timer.Flags = HiltTimer_None;
+	Timer.Next = FirstFree;
+	FirstFree = Index;
+}
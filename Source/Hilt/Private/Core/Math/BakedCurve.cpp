@@ -0,0 +1,355 @@
+#include "Core/Math/BakedCurve.h"
+
+#include "Curves/CurveFloat.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/UnrealType.h"
+
+namespace
+{
+	//the min and max number of samples in a table
+	constexpr int32 MinSamples = 64;
+	constexpr int32 MaxSamples = 4096;
+
+	//the max error allowed between a table and its curve (relative to the value range of the curve)
+	constexpr float MaxRelativeError = 0.001f;
+
+	//the baked tables of every curve that has been evaluated
+	TMap<TObjectKey<UCurveFloat>, TUniquePtr<FBakedCurveFloat>> BakedCurves;
+
+	//the tables that were replaced (kept alive since a worker thread might still be reading them, freed after the next garbage collection)
+	TArray<TUniquePtr<FBakedCurveFloat>> RetiredCurves;
+
+	//function to check if an extrapolation mode can't be represented by clamping the table
+	bool IsUnsupportedExtrapolation(const ERichCurveExtrapolation Extrapolation)
+	{
+		return Extrapolation == RCCE_Linear || Extrapolation == RCCE_Cycle || Extrapolation == RCCE_CycleWithOffset || Extrapolation == RCCE_Oscillate;
+	}
+
+	//function to throw away the table of a curve so it's rebaked on next use
+	void RetireCurve(const UCurveFloat* Curve)
+	{
+		//check if the curve has a table
+		TUniquePtr<FBakedCurveFloat> Baked;
+		if (!BakedCurves.RemoveAndCopyValue(Curve, Baked))
+		{
+			return;
+		}
+
+		//keep the table alive and invalidate the cache
+		RetiredCurves.Add(MoveTemp(Baked));
+		++HiltCurves::Generation;
+	}
+
+	//function to bake the curves referenced by the properties of a struct or class
+	void BakeStructCurves(const UStruct* Struct, const void* Data, const int32 Depth)
+	{
+		//iterate through the properties
+		for (TFieldIterator<FProperty> It(Struct); It; ++It)
+		{
+			//check if the property is a curve
+			if (const FObjectProperty* ObjectProperty = CastField<FObjectProperty>(*It); ObjectProperty && ObjectProperty->PropertyClass->IsChildOf(UCurveFloat::StaticClass()))
+			{
+				for (int32 Index = 0; Index < ObjectProperty->ArrayDim; ++Index)
+				{
+					if (const UCurveFloat* Curve = Cast<UCurveFloat>(ObjectProperty->GetObjectPropertyValue_InContainer(Data, Index)))
+					{
+						HiltCurves::FindOrBake(Curve);
+					}
+				}
+			}
+			//check if the property is a struct (only go a couple of levels deep)
+			else if (const FStructProperty* StructProperty = CastField<FStructProperty>(*It); StructProperty && Depth < 2)
+			{
+				BakeStructCurves(StructProperty->Struct, StructProperty->ContainerPtrToValuePtr<void>(Data), Depth + 1);
+			}
+			//check if the property is an array of structs
+			else if (const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(*It); ArrayProperty && Depth < 2)
+			{
+				if (const FStructProperty* InnerStruct = CastField<FStructProperty>(ArrayProperty->Inner))
+				{
+					FScriptArrayHelper ArrayHelper(ArrayProperty, ArrayProperty->ContainerPtrToValuePtr<void>(Data));
+					for (int32 Index = 0; Index < ArrayHelper.Num(); ++Index)
+					{
+						BakeStructCurves(InnerStruct->Struct, ArrayHelper.GetRawPtr(Index), Depth + 1);
+					}
+				}
+			}
+		}
+	}
+
+	//function called after garbage collection (destroyed curves can have their addresses reused by new ones)
+	void OnPostGarbageCollect()
+	{
+		//throw away the tables of destroyed curves
+		for (auto It = BakedCurves.CreateIterator(); It; ++It)
+		{
+			if (!It.Key().ResolveObjectPtr())
+			{
+				It.RemoveCurrent();
+			}
+		}
+
+		//free the retired tables (worker threads reading baked tables, like the grapple preview, are waited on before garbage collection)
+		RetiredCurves.Empty();
+
+		//invalidate the cache so no entry matches a reused address
+		++HiltCurves::Generation;
+	}
+
+#if WITH_EDITOR
+	//function called when a curve is edited in the curve editor
+	void OnCurveUpdated(UCurveBase* Curve, EPropertyChangeType::Type ChangeType)
+	{
+		RetireCurve(Cast<UCurveFloat>(Curve));
+	}
+
+	//function called when a property of any object is edited
+	void OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
+	{
+		//check if the object is a curve
+		if (const UCurveFloat* Curve = Cast<UCurveFloat>(Object))
+		{
+			RetireCurve(Curve);
+		}
+	}
+#endif
+
+	//the console commands for the baked curves
+	FAutoConsoleCommand ReportCommand(TEXT("Hilt.Curves.Report"), TEXT("Prints the size and max error of every baked float curve"), FConsoleCommandDelegate::CreateStatic(&HiltCurves::ReportErrors));
+	FAutoConsoleCommand RebakeCommand(TEXT("Hilt.Curves.Rebake"), TEXT("Throws away every baked float curve so they're rebaked on next use"), FConsoleCommandDelegate::CreateStatic(&HiltCurves::RebakeAll));
+}
+
+HiltCurves::FCacheEntry HiltCurves::Cache[CacheSize];
+uint32 HiltCurves::Generation = 1;
+
+void FBakedCurveFloat::Bake(const UCurveFloat* Curve)
+{
+	//reset the table
+	Source = Curve;
+	Samples.Reset();
+	MaxError = 0;
+
+	//check if the curve extrapolates in a way we can't clamp to
+	const FRichCurve& RichCurve = Curve->FloatCurve;
+	bPassThrough = IsUnsupportedExtrapolation(RichCurve.PreInfinityExtrap) || IsUnsupportedExtrapolation(RichCurve.PostInfinityExtrap);
+	if (bPassThrough)
+	{
+		return;
+	}
+
+	//get the time range of the curve
+	float CurveMinTime = 0;
+	float CurveMaxTime = 0;
+	RichCurve.GetTimeRange(CurveMinTime, CurveMaxTime);
+
+	//check if the curve is constant
+	if (RichCurve.GetNumKeys() < 2 || CurveMaxTime <= CurveMinTime)
+	{
+		//store the constant value
+		MinTime = CurveMinTime;
+		InvStep = 0;
+		Samples.Init(Curve->GetFloatValue(CurveMinTime), 2);
+		return;
+	}
+
+	//get the error we allow for the value range of the curve
+	float CurveMinValue = 0;
+	float CurveMaxValue = 0;
+	RichCurve.GetValueRange(CurveMinValue, CurveMaxValue);
+	const float Tolerance = MaxRelativeError * FMath::Max(CurveMaxValue - CurveMinValue, 1.f);
+
+	//double the number of samples until the table is close enough to the curve
+	for (int32 NumSamples = MinSamples; ; NumSamples *= 2)
+	{
+		//get the time between samples
+		const float Step = (CurveMaxTime - CurveMinTime) / (NumSamples - 1);
+		MinTime = CurveMinTime;
+		InvStep = 1 / Step;
+
+		//sample the curve
+		Samples.SetNumUninitialized(NumSamples);
+		for (int32 Index = 0; Index < NumSamples; ++Index)
+		{
+			Samples[Index] = Curve->GetFloatValue(CurveMinTime + Index * Step);
+		}
+
+		//measure the error between the samples
+		MaxError = 0;
+		for (int32 Index = 0; Index < NumSamples - 1; ++Index)
+		{
+			for (int32 SubStep = 1; SubStep < 4; ++SubStep)
+			{
+				const float Time = CurveMinTime + (Index + SubStep / 4.f) * Step;
+				MaxError = FMath::Max(MaxError, FMath::Abs(Evaluate(Time) - Curve->GetFloatValue(Time)));
+			}
+		}
+
+		//measure the error at the keys (catches stepped keys between samples)
+		for (const FRichCurveKey& Key : RichCurve.GetConstRefOfKeys())
+		{
+			MaxError = FMath::Max(MaxError, FMath::Abs(Evaluate(Key.Time) - Curve->GetFloatValue(Key.Time)));
+		}
+
+		//check if the table is close enough or can't get any bigger
+		if (MaxError <= Tolerance || NumSamples >= MaxSamples)
+		{
+			break;
+		}
+	}
+}
+
+float FBakedCurveFloat::Evaluate(const float Time) const
+{
+	//check if we have to evaluate the source curve
+	if (bPassThrough)
+	{
+		return Source->GetFloatValue(Time);
+	}
+
+	//get the position of the time in the table
+	const float Position = FMath::Clamp((Time - MinTime) * InvStep, 0.f, float(Samples.Num() - 1));
+	const int32 Index = FMath::Min(int32(Position), Samples.Num() - 2);
+
+	//interpolate between the two samples around the time
+	return FMath::Lerp(Samples[Index], Samples[Index + 1], Position - Index);
+}
+
+void FBakedCurveFloat::EvaluateBatch(const TArrayView<const float> Times, const TArrayView<float> OutValues) const
+{
+	check(Times.Num() == OutValues.Num());
+
+	//check if we have to evaluate the source curve
+	if (bPassThrough)
+	{
+		for (int32 Index = 0; Index < Times.Num(); ++Index)
+		{
+			OutValues[Index] = Source->GetFloatValue(Times[Index]);
+		}
+
+		return;
+	}
+
+	//the constants for the table
+	const VectorRegister4Float VectorMinTime = VectorSetFloat1(MinTime);
+	const VectorRegister4Float VectorInvStep = VectorSetFloat1(InvStep);
+	const VectorRegister4Float VectorMaxPosition = VectorSetFloat1(float(Samples.Num() - 1));
+	const int32 LastIndex = Samples.Num() - 2;
+
+	//evaluate four times at a time
+	int32 Index = 0;
+	for (; Index + 4 <= Times.Num(); Index += 4)
+	{
+		//get the positions of the times in the table
+		const VectorRegister4Float Position = VectorMin(VectorMax(VectorMultiply(VectorSubtract(VectorLoad(&Times[Index]), VectorMinTime), VectorInvStep), VectorZeroFloat()), VectorMaxPosition);
+
+		//split the positions into sample indices (the positions are positive so truncating floors them)
+		alignas(16) float Wholes[4];
+		VectorStoreAligned(VectorTruncate(Position), Wholes);
+
+		//gather the samples around each position
+		alignas(16) float From[4];
+		alignas(16) float To[4];
+		for (int32 Lane = 0; Lane < 4; ++Lane)
+		{
+			const int32 SampleIndex = FMath::Min(int32(Wholes[Lane]), LastIndex);
+			From[Lane] = Samples[SampleIndex];
+			To[Lane] = Samples[SampleIndex + 1];
+			Wholes[Lane] = float(SampleIndex);
+		}
+
+		//interpolate between the samples
+		const VectorRegister4Float VectorFrom = VectorLoadAligned(From);
+		const VectorRegister4Float Alpha = VectorSubtract(Position, VectorLoadAligned(Wholes));
+		VectorStore(VectorMultiplyAdd(VectorSubtract(VectorLoadAligned(To), VectorFrom), Alpha, VectorFrom), &OutValues[Index]);
+	}
+
+	//evaluate the remaining times
+	for (; Index < Times.Num(); ++Index)
+	{
+		OutValues[Index] = Evaluate(Times[Index]);
+	}
+}
+
+const FBakedCurveFloat* HiltCurves::FindOrBake(const UCurveFloat* Curve)
+{
+	check(IsInGameThread());
+
+	//listen for curves being destroyed and edited (once)
+	static bool bBoundDelegates = false;
+	if (!bBoundDelegates)
+	{
+		bBoundDelegates = true;
+		FCoreUObjectDelegates::GetPostGarbageCollect().AddStatic(&OnPostGarbageCollect);
+#if WITH_EDITOR
+		FCoreUObjectDelegates::OnObjectPropertyChanged.AddStatic(&OnObjectPropertyChanged);
+		FCoreUObjectDelegates::ReloadCompleteDelegate.AddLambda([](EReloadCompleteReason) { RebakeAll(); });
+#endif
+	}
+
+	//get the table of the curve
+	TUniquePtr<FBakedCurveFloat>& Baked = BakedCurves.FindOrAdd(Curve);
+
+	//check if the curve hasn't been baked yet
+	if (!Baked)
+	{
+		//bake the table
+		Baked = MakeUnique<FBakedCurveFloat>();
+		Baked->Bake(Curve);
+
+#if WITH_EDITOR
+		//rebake the curve when it's edited in the curve editor
+		const_cast<UCurveFloat*>(Curve)->OnUpdateCurve.AddStatic(&OnCurveUpdated);
+#endif
+	}
+
+	//store the table in the cache
+	FCacheEntry& Entry = Cache[(UPTRINT(Curve) >> 4) & (CacheSize - 1)];
+	Entry.Curve = Curve;
+	Entry.Baked = Baked.Get();
+	Entry.Generation = Generation;
+
+	return Baked.Get();
+}
+
+void HiltCurves::BakeReferencedCurves(const UObject* Object)
+{
+	//check if the object is valid
+	if (!Object)
+	{
+		return;
+	}
+
+	//bake the curves of the object's properties
+	BakeStructCurves(Object->GetClass(), Object, 0);
+}
+
+void HiltCurves::RebakeAll()
+{
+	//retire every table
+	for (TPair<TObjectKey<UCurveFloat>, TUniquePtr<FBakedCurveFloat>>& Pair : BakedCurves)
+	{
+		RetiredCurves.Add(MoveTemp(Pair.Value));
+	}
+	BakedCurves.Reset();
+
+	//invalidate the cache
+	++Generation;
+}
+
+void HiltCurves::ReportErrors()
+{
+	//the totals of all tables
+	int64 TotalBytes = 0;
+
+	//print every table
+	for (const TPair<TObjectKey<UCurveFloat>, TUniquePtr<FBakedCurveFloat>>& Pair : BakedCurves)
+	{
+		const FBakedCurveFloat& Baked = *Pair.Value;
+		TotalBytes += Baked.Samples.GetAllocatedSize();
+		UE_LOG(LogTemp, Display, TEXT("BakedCurve: %s %d samples, max error %.6f%s"), *GetNameSafe(Baked.Source), Baked.Samples.Num(), Baked.MaxError, Baked.bPassThrough ? TEXT(" (pass-through, unsupported extrapolation)") : TEXT(""));
+	}
+
+	//print the totals
+	UE_LOG(LogTemp, Display, TEXT("BakedCurve: %d curves, %lld bytes"), BakedCurves.Num(), TotalBytes);
+}
@@ -0,0 +1,140 @@
+#include "Core/MovementTelemetry.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/RunnableThread.h"
+
+namespace
+{
+	//the mask to get the ring index of a record count
+	constexpr uint32 RingMask = FMovementTelemetryWriter::RingCapacity - 1;
+	static_assert((FMovementTelemetryWriter::RingCapacity & RingMask) == 0, "the ring capacity has to be a power of two");
+
+	//how long the writer thread sleeps when the ring is empty (in seconds)
+	constexpr float WriterSleepTime = 0.05f;
+}
+
+TUniquePtr<FMovementTelemetryWriter> FMovementTelemetryWriter::CreateFromCommandLine(const FString& DefaultName)
+{
+	//check if we were given a file
+	FString FilePath;
+	if (!FParse::Value(FCommandLine::Get(), TEXT("HiltTelemetry="), FilePath))
+	{
+		//check if telemetry is enabled without a file
+		if (!FParse::Param(FCommandLine::Get(), TEXT("HiltTelemetry")))
+		{
+			return nullptr;
+		}
+
+		//use a timestamped file in the saved folder
+		FilePath = FPaths::ProjectSavedDir() / FString::Printf(TEXT("Telemetry/%s_%s.htel"), *DefaultName, *FDateTime::Now().ToString());
+	}
+
+	return MakeUnique<FMovementTelemetryWriter>(FilePath);
+}
+
+FMovementTelemetryWriter::FMovementTelemetryWriter(const FString& InFilePath) : FilePath(InFilePath)
+{
+	//allocate the ring up front so recording never allocates
+	Ring.SetNumZeroed(RingCapacity);
+
+	//start the writer thread
+	Thread = FRunnableThread::Create(this, TEXT("MovementTelemetryWriter"), 0, TPri_BelowNormal);
+}
+
+FMovementTelemetryWriter::~FMovementTelemetryWriter()
+{
+	//check if the thread was started
+	if (Thread)
+	{
+		//stop it and wait for it to write everything recorded
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+}
+
+void FMovementTelemetryWriter::Record(const FMovementTelemetryRecord& InRecord)
+{
+	//get the count of records pushed so far
+	const uint32 Write = WriteCount.load(std::memory_order_relaxed);
+
+	//check if the ring is full (the writer is a whole ring behind)
+	if (Write - ReadCount.load(std::memory_order_acquire) >= RingCapacity)
+	{
+		//drop the record
+		NumDropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	//copy the record into the ring and publish it to the writer thread
+	Ring.GetData()[Write & RingMask] = InRecord;
+	WriteCount.store(Write + 1, std::memory_order_release);
+}
+
+uint32 FMovementTelemetryWriter::Run()
+{
+	//open the file (on this thread, so the game thread never waits on the disk)
+	const TUniquePtr<FArchive> Archive(IFileManager::Get().CreateFileWriter(*FilePath));
+	if (!Archive)
+	{
+		UE_LOG(LogTemp, Error, TEXT("MovementTelemetry: failed to open %s"), *FilePath);
+		return 1;
+	}
+
+	//write the header
+	FMovementTelemetryHeader Header;
+	Archive->Serialize(&Header, sizeof(Header));
+
+	//keep draining the ring until we're stopped
+	uint64 NumWritten = 0;
+	while (!bStopping.load(std::memory_order_acquire))
+	{
+		//write the new records and sleep if there weren't any
+		const uint32 NumDrained = Drain(*Archive);
+		NumWritten += NumDrained;
+		if (NumDrained == 0)
+		{
+			FPlatformProcess::Sleep(WriterSleepTime);
+		}
+	}
+
+	//write whatever was recorded before we were stopped
+	NumWritten += Drain(*Archive);
+	Archive->Close();
+
+	//print the summary
+	UE_LOG(LogTemp, Display, TEXT("MovementTelemetry: wrote %llu records to %s (%u dropped)"), NumWritten, *FilePath, GetNumDropped());
+
+	return 0;
+}
+
+void FMovementTelemetryWriter::Stop()
+{
+	bStopping.store(true, std::memory_order_release);
+}
+
+uint32 FMovementTelemetryWriter::Drain(FArchive& Archive)
+{
+	//get the records pushed since the last drain
+	const uint32 Read = ReadCount.load(std::memory_order_relaxed);
+	const uint32 Write = WriteCount.load(std::memory_order_acquire);
+	const uint32 Count = Write - Read;
+	if (Count == 0)
+	{
+		return 0;
+	}
+
+	//write them straight from the ring (in two parts if they wrap around the end)
+	const uint32 Start = Read & RingMask;
+	const uint32 FirstPart = FMath::Min(Count, RingCapacity - Start);
+	Archive.Serialize(Ring.GetData() + Start, FirstPart * sizeof(FMovementTelemetryRecord));
+	if (Count > FirstPart)
+	{
+		Archive.Serialize(Ring.GetData(), (Count - FirstPart) * sizeof(FMovementTelemetryRecord));
+	}
+
+	//free the slots for the game thread
+	ReadCount.store(Write, std::memory_order_release);
+
+	return Count;
+}
@@ -51,8 +51,7 @@ void ALaunchPad::AddLevelPresence()
 	Super::AddLevelPresence();
 
 	// Reset cooldown
-	GetWorld()->GetTimerManager().ClearTimer(MainTimerHandler);
-	CooldownComplete();
+	ResetCooldown();
 
 	// Trigger Collision Box ------------
 	// Enable collision
@@ -62,7 +61,11 @@ void ALaunchPad::AddLevelPresence()
 void ALaunchPad::ResetCooldown()
 {
 	// Reset cooldown
-	GetWorld()->GetTimerManager().ClearTimer(MainTimerHandler);
+	if (UHiltTimerSubsystem* TimerSubsystem = UHiltTimerSubsystem::Get(this))
+	{
+		// Clear the cooldown timer
+		TimerSubsystem->ClearTimer(MainTimerHandler);
+	}
 	CooldownComplete();
 }
 
@@ -75,7 +78,11 @@ void ALaunchPad::OnOverlap(UPrimitiveComponent* OverlappedComponent, AActor* Oth
 		// Sets jumped bool so that function does not repeat.
 		CoolingDown = true;
 		// Resets Jumped to false when x seconds has gone. 
-		GetWorldTimerManager().SetTimer(MainTimerHandler, this, &ALaunchPad::CooldownComplete, LaunchPadCoolDownTime);
+		if (UHiltTimerSubsystem* TimerSubsystem = UHiltTimerSubsystem::Get(this))
+		{
+			// Start the cooldown timer
+			TimerSubsystem->SetTimer(MainTimerHandler, this, &ALaunchPad::CooldownComplete, LaunchPadCoolDownTime);
+		}
 	}
 }
 
@@ -1,10 +1,38 @@
 #include "NPC/Components/GrappleableComponent.h"
 
+#include "Components/GrapplingHook/GrappleTargetSubsystem.h"
+
 UGrappleableComponent::UGrappleableComponent()
 {
 	PrimaryComponentTick.bCanEverTick = true;
 }
 
+void UGrappleableComponent::OnRegister()
+{
+	//call the parent implementation
+	Super::OnRegister();
+
+	//check if the world has a grapple target subsystem
+	if (UGrappleTargetSubsystem* GrappleTargetSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UGrappleTargetSubsystem>() : nullptr)
+	{
+		//register this component as a grapple target
+		GrappleTargetSubsystem->RegisterTarget(this);
+	}
+}
+
+void UGrappleableComponent::OnUnregister()
+{
+	//check if the world has a grapple target subsystem
+	if (UGrappleTargetSubsystem* GrappleTargetSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UGrappleTargetSubsystem>() : nullptr)
+	{
+		//unregister this component as a grapple target
+		GrappleTargetSubsystem->UnregisterTarget(this);
+	}
+
+	//call the parent implementation
+	Super::OnUnregister();
+}
+
 void UGrappleableComponent::OnStartGrapple(const FHitResult& HitResult)
 {
 	//get the hit location as relative to this actor
@@ -3,16 +3,36 @@
 #include "Components/PlayerMovementComponent.h"
 #include "Components/Camera/CameraArmComponent.h"
 #include "Components/Camera/PlayerCameraComponent.h"
+#include "Components/GroundProbeComponent.h"
 #include "Components/GrapplingHook/GrapplingComponent.h"
 #include "Components/TerrainGun/TerrainGunComponent.h"
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
 //#include "Components/SphereComponent.h"
 #include "Components/RocketLauncherComponent.h"
+#include "Core/HiltSimulationSubsystem.h"
 #include "Components/GrapplingHook/RopeComponent.h"
 #include "Core/HiltGameModeBase.h"
 #include "Player/ScoreComponent.h"
 
+namespace
+{
+	//console command to rewind the first local player (for qa)
+	FAutoConsoleCommandWithWorldAndArgs RewindCommand(TEXT("Hilt.Rewind"), TEXT("Rewinds the local player by the given number of seconds: Hilt.Rewind <seconds>"), FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, const UWorld* World)
+	{
+		//get the first local player's character
+		const APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+		APlayerCharacter* PlayerCharacter = PlayerController ? Cast<APlayerCharacter>(PlayerController->GetPawn()) : nullptr;
+		if (!PlayerCharacter)
+		{
+			return;
+		}
+
+		//rewind it (a second if no time was given)
+		PlayerCharacter->RewindSeconds(Args.IsEmpty() ? 1.f : FCString::Atof(*Args[0]));
+	}));
+}
+
 APlayerCharacter::APlayerCharacter(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer.SetDefaultSubobjectClass<UPlayerMovementComponent>(CharacterMovementComponentName))
 {
 	//Enable ticking
@@ -35,6 +55,7 @@ APlayerCharacter::APlayerCharacter(const FObjectInitializer& ObjectInitializer)
 	GrappleComponent = CreateDefaultSubobject<UGrapplingComponent>(GET_FUNCTION_NAME_CHECKED(APlayerCharacter, GrappleComponent));
 	RopeComponent = CreateDefaultSubobject<URopeComponent>(GET_FUNCTION_NAME_CHECKED(APlayerCharacter, RopeComponent));
 	ScoreComponent = CreateDefaultSubobject<UScoreComponent>(GET_FUNCTION_NAME_CHECKED(APlayerCharacter, ScoreComponent));
+	GroundProbeComponent = CreateDefaultSubobject<UGroundProbeComponent>(GET_FUNCTION_NAME_CHECKED(APlayerCharacter, GroundProbeComponent));
 
 	//setup attachments
 	CameraArm->SetupAttachment(GetRootComponent());
@@ -96,6 +117,235 @@ void APlayerCharacter::BeginPlay()
 
 	//get the game mode
 	GameMode = GetWorld()->GetAuthGameMode<AHiltGameModeBase>();
+
+	//check if we're locally controlled and have a simulation subsystem
+	if (UHiltSimulationSubsystem* Simulation = GetWorld()->GetSubsystem<UHiltSimulationSubsystem>(); Simulation && IsLocallyControlled())
+	{
+		//register with it (only does anything in fixed-step mode)
+		Simulation->RegisterPlayer(this);
+	}
+
+	//allocate the rewind history up front so recording and rewinding never allocate
+	RewindHistory.SetCapacity(GetNetMode() != NM_DedicatedServer ? RewindHistoryLength : 0, RewindPivotCapacity);
+}
+
+bool APlayerCharacter::QueueSimulationButtons(const uint8 Buttons) const
+{
+	//get the simulation subsystem and queue the buttons in it
+	UHiltSimulationSubsystem* Simulation = GetWorld()->GetSubsystem<UHiltSimulationSubsystem>();
+	return Simulation && Simulation->QueueButtons(Buttons);
+}
+
+void APlayerCharacter::CaptureRewindFrame()
+{
+	//check if the rewind history is disabled
+	if (RewindHistory.GetCapacity() == 0)
+	{
+		return;
+	}
+
+	//get the gameplay time and the recorded time (without the time rewound away)
+	const double GameplayTime = UHiltSimulationSubsystem::GetGameplayTime(this);
+	const double RecordedTime = GameplayTime - RewindTimeOffset;
+
+	//check if it's not time for the next rewind step yet (with some slack for the rounding of fixed steps)
+	if (RecordedTime + KINDA_SMALL_NUMBER < NextRewindCaptureTime)
+	{
+		return;
+	}
+
+	//set the time of the next capture (without catching up on steps a long frame skipped)
+	NextRewindCaptureTime = FMath::Max(NextRewindCaptureTime + 1.0 / RewindStepRate, RecordedTime);
+
+	//get the number of rope pivots to save (a rope with more pivots than a frame can hold is saved as not grappling)
+	int32 NumPivots = GrappleComponent->bIsGrappling ? RopeComponent->GetNumRewindPivots() : 0;
+	NumPivots = NumPivots <= static_cast<int32>(MAX_uint8) ? NumPivots : 0;
+
+	//get the frame to write
+	FPlayerRewindPivot* Pivots = nullptr;
+	FPlayerRewindFrame& Frame = RewindHistory.Push(NumPivots, Pivots);
+
+	//save the rope pivots
+	if (Pivots)
+	{
+		RopeComponent->SaveRewindPivots(Pivots, NumPivots);
+	}
+
+	//save the time and transform
+	const FVector Location = GetActorLocation();
+	const FRotator Rotation = GetActorRotation();
+	const FRotator ControlRotation = GetControlRotation();
+	Frame.Time = static_cast<float>(RecordedTime);
+	Frame.Location = FVector3f(Location);
+	Frame.Rotation[0] = FRotator::CompressAxisToShort(Rotation.Pitch);
+	Frame.Rotation[1] = FRotator::CompressAxisToShort(Rotation.Yaw);
+	Frame.Rotation[2] = FRotator::CompressAxisToShort(Rotation.Roll);
+	Frame.ControlPitch = FRotator::CompressAxisToShort(ControlRotation.Pitch);
+	Frame.ControlYaw = FRotator::CompressAxisToShort(ControlRotation.Yaw);
+
+	//save the velocity (rounded to whole cm/s)
+	const FVector& Velocity = PlayerMovementComponent->Velocity;
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		Frame.Velocity[Axis] = static_cast<int16>(FMath::Clamp(FMath::RoundToInt32(Velocity[Axis]), static_cast<int32>(MIN_int16), static_cast<int32>(MAX_int16)));
+	}
+
+	//save the movement state
+	Frame.MovementMode = PlayerMovementComponent->MovementMode;
+	Frame.CustomMovementMode = PlayerMovementComponent->CustomMovementMode;
+	Frame.SlideSpeed = static_cast<uint16>(FMath::Clamp(FMath::RoundToInt32(PlayerMovementComponent->CurrentSlideSpeed), 0, static_cast<int32>(MAX_uint16)));
+	Frame.SlideJumpTimeMs = static_cast<uint16>(FMath::Clamp(FMath::RoundToInt32(PlayerMovementComponent->SlideJumpTimeRemaining * 1000), 0, static_cast<int32>(MAX_uint16)));
+	Frame.PendingSlideScore = PlayerMovementComponent->PendingSlideScore;
+	Frame.SlideSpeedGained = PlayerMovementComponent->SlideSpeedGained;
+	Frame.SlideStartAge = static_cast<float>(GameplayTime - PlayerMovementComponent->SlideStartTime);
+	Frame.DiveStartAge = static_cast<float>(GameplayTime - PlayerMovementComponent->DiveStartTime);
+	Frame.DiveStopAge = static_cast<float>(GameplayTime - PlayerMovementComponent->DiveStopTime);
+	Frame.Flags = (PlayerMovementComponent->bIsSliding ? PlayerRewind_Sliding : 0)
+		| (PlayerMovementComponent->bIsDiving ? PlayerRewind_Diving : 0)
+		| (PlayerMovementComponent->bIsSlideJumping ? PlayerRewind_SlideJumping : 0)
+		| (PlayerMovementComponent->bIsSlideFalling ? PlayerRewind_SlideFalling : 0)
+		| (PlayerMovementComponent->bMightBeBunnyJumping ? PlayerRewind_MightBeBunnyJumping : 0)
+		| (NumPivots >= 2 ? PlayerRewind_Grappling : 0);
+
+	//save the score
+	Frame.Score = ScoreComponent->Score;
+}
+
+bool APlayerCharacter::RewindFrames(const int32 FramesAgo)
+{
+	//get the frame to restore
+	const FPlayerRewindFrame* Frame = RewindHistory.GetFromNewest(FramesAgo);
+	if (!Frame)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Rewind: no frame %d steps ago (%d recorded)"), FramesAgo, RewindHistory.Num());
+		return false;
+	}
+
+	//get the rope pivots of the frame
+	const bool bWasGrappling = (Frame->Flags & PlayerRewind_Grappling) != 0;
+	const FPlayerRewindPivot* Pivots = bWasGrappling ? RewindHistory.GetPivots(*Frame) : nullptr;
+
+	//check if the rope pivots have been overwritten or the grapple target doesn't exist anymore
+	AActor* GrappleTarget = Pivots ? Pivots[Frame->NumPivots - 1].AttachedActor.Get() : nullptr;
+	if (bWasGrappling && !GrappleTarget)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Rewind: the grapple of the frame %d steps ago can't be restored"), FramesAgo);
+		return false;
+	}
+
+	//check if the frame wasn't grappling and we are
+	if (!bWasGrappling && GrappleComponent->bIsGrappling)
+	{
+		//stop grappling
+		GrappleComponent->StopGrapple(false);
+	}
+	//check if the frame was grappling something else than we are
+	else if (bWasGrappling && (!GrappleComponent->bIsGrappling || GrappleComponent->GrappleTarget != GrappleTarget))
+	{
+		//start grappling the frame's target (the rope is rebuilt from the pivots below)
+		const FVector HitLocation = GrappleTarget->GetTransform().TransformPosition(FVector(Pivots[Frame->NumPivots - 1].Location));
+		FHitResult HitResult(GrappleTarget, Cast<UPrimitiveComponent>(GrappleTarget->GetRootComponent()), HitLocation, FVector::UpVector);
+		HitResult.bBlockingHit = true;
+		GrappleComponent->StartGrapple(HitResult);
+	}
+
+	//restore the transform
+	SetActorLocationAndRotation(FVector(Frame->Location), FRotator(FRotator::DecompressAxisFromShort(Frame->Rotation[0]), FRotator::DecompressAxisFromShort(Frame->Rotation[1]), FRotator::DecompressAxisFromShort(Frame->Rotation[2])), false, nullptr, ETeleportType::TeleportPhysics);
+	if (Controller)
+	{
+		Controller->SetControlRotation(FRotator(FRotator::DecompressAxisFromShort(Frame->ControlPitch), FRotator::DecompressAxisFromShort(Frame->ControlYaw), 0));
+	}
+
+	//rebuild the rope (after the transform, since the pivots relative to the owner use its location)
+	if (bWasGrappling)
+	{
+		RopeComponent->RestoreRewindPivots(Pivots, Frame->NumPivots);
+	}
+
+	//restore the movement state
+	PlayerMovementComponent->Velocity = FVector(Frame->Velocity[0], Frame->Velocity[1], Frame->Velocity[2]);
+	PlayerMovementComponent->bIsDiving = (Frame->Flags & PlayerRewind_Diving) != 0;
+	PlayerMovementComponent->bIsSlideJumping = (Frame->Flags & PlayerRewind_SlideJumping) != 0;
+	PlayerMovementComponent->bIsSlideFalling = (Frame->Flags & PlayerRewind_SlideFalling) != 0;
+	PlayerMovementComponent->bMightBeBunnyJumping = (Frame->Flags & PlayerRewind_MightBeBunnyJumping) != 0;
+	PlayerMovementComponent->CurrentSlideSpeed = Frame->SlideSpeed;
+	PlayerMovementComponent->SlideJumpTimeRemaining = Frame->SlideJumpTimeMs / 1000.f;
+
+	//restore the gravity scale (the grapple manages it while grappling)
+	if (PlayerMovementComponent->bIsSlideJumping)
+	{
+		PlayerMovementComponent->GravityScale = 0;
+	}
+	else if (!bWasGrappling)
+	{
+		PlayerMovementComponent->GravityScale = PlayerMovementComponent->DefaultGravityScale;
+	}
+
+	//restore the movement mode and find the floor at the restored location (setting the same mode again doesn't)
+	PlayerMovementComponent->SetMovementMode(static_cast<EMovementMode>(Frame->MovementMode), Frame->CustomMovementMode);
+	if (PlayerMovementComponent->IsMovingOnGround())
+	{
+		PlayerMovementComponent->FindFloor(GetActorLocation(), PlayerMovementComponent->CurrentFloor, false);
+	}
+
+	//restore the slide state (after the movement mode, so the slide score banking matches the restored slide) and the score
+	PlayerMovementComponent->RestoreSlideState((Frame->Flags & PlayerRewind_Sliding) != 0, Frame->PendingSlideScore, Frame->SlideSpeedGained);
+	ScoreComponent->RestoreScore(Frame->Score);
+
+	//restore the slide and dive times relative to the current gameplay time (so the dive curves and the slide score decay continue from the frame)
+	const double GameplayTime = UHiltSimulationSubsystem::GetGameplayTime(this);
+	PlayerMovementComponent->SlideStartTime = static_cast<float>(GameplayTime - Frame->SlideStartAge);
+	PlayerMovementComponent->DiveStartTime = static_cast<float>(GameplayTime - Frame->DiveStartAge);
+	PlayerMovementComponent->DiveStopTime = static_cast<float>(GameplayTime - Frame->DiveStopAge);
+
+	//skip the rewound time in the recorded times (the next capture continues from the frame's time instead of leaving a gap)
+	RewindTimeOffset = GameplayTime - Frame->Time;
+	NextRewindCaptureTime = Frame->Time + 1.0 / RewindStepRate;
+
+	//drop the frames after the restored one (the next capture continues from it)
+	RewindHistory.DiscardNewest(FramesAgo);
+
+	return true;
+}
+
+bool APlayerCharacter::RewindSeconds(const float Seconds)
+{
+	//get the newest frame
+	const FPlayerRewindFrame* Newest = RewindHistory.GetFromNewest(0);
+	if (!Newest)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Rewind: nothing has been recorded"));
+		return false;
+	}
+
+	//binary search for the newest frame at or before the target time (the frames get older with the offset)
+	const float TargetTime = Newest->Time - FMath::Max(Seconds, 0.f);
+	int32 Low = 0;
+	int32 High = RewindHistory.Num() - 1;
+	while (Low < High)
+	{
+		//check if the middle frame is still after the target time
+		const int32 Middle = (Low + High) / 2;
+		if (RewindHistory.GetFromNewest(Middle)->Time > TargetTime)
+		{
+			Low = Middle + 1;
+		}
+		else
+		{
+			High = Middle;
+		}
+	}
+
+	//rewind to it (or the oldest frame)
+	return RewindFrames(Low);
+}
+
+void APlayerCharacter::ResetRewindHistory()
+{
+	RewindHistory.Reset();
+
+	//capture the next step right away
+	NextRewindCaptureTime = 0;
 }
 
 void APlayerCharacter::ShowStreamingLevel(TArray<FName> LevelsToShow)
@@ -282,6 +532,12 @@ void APlayerCharacter::FireRocketLauncher(const FInputActionValue& Value)
 		return;
 	}
 
+	//check if the fixed-step simulation will fire on its next step
+	if (QueueSimulationButtons(HiltInput_Fire))
+	{
+		return;
+	}
+
 	//fire the rocket launcher
 	RocketLauncherComponent->FireProjectile(Camera->GetForwardVector());
 }
@@ -313,6 +569,12 @@ void APlayerCharacter::ShootGrapple(const FInputActionValue& Value)
 	//check if we can grapple
 	if (bCanActivateGrapple)
 	{
+		//check if the fixed-step simulation will start the grapple on its next step
+		if (QueueSimulationButtons(HiltInput_Grapple))
+		{
+			return;
+		}
+
 		//check if we can start the grapple
 		GrappleComponent->StartGrappleCheck();
 	}
@@ -321,6 +583,13 @@ void APlayerCharacter::ShootGrapple(const FInputActionValue& Value)
 void APlayerCharacter::StopGrapple(const FInputActionValue& Value)
 {
 	hasStartedMoving = true;
+
+	//check if the fixed-step simulation will stop the grapple on its next step
+	if (QueueSimulationButtons(HiltInput_StopGrapple))
+	{
+		return;
+	}
+
 	//check if we can grapple
 	if (bCanActivateGrapple)
 	{
@@ -342,18 +611,8 @@ void APlayerCharacter::StartDiveOrSlide(const FInputActionValue& Value)
 		return;
 	}
 
-	//check if we're in the air
-	if (GetCharacterMovement()->IsFalling())
-	{
-		//start the dive
-		PlayerMovementComponent->StartDive();
-
-		//return to prevent further execution
-		return;
-	}
-
-	//start the slide
-	PlayerMovementComponent->StartSlide();
+	//hold the slide button (the movement component dives in the air and slides on the ground, so it's predicted with the moves)
+	PlayerMovementComponent->bWantsToSlide = true;
 }
 
 void APlayerCharacter::StopDiveOrSlide(const FInputActionValue& Value)
@@ -366,11 +625,8 @@ void APlayerCharacter::StopDiveOrSlide(const FInputActionValue& Value)
 		return;
 	}
 
-	//stop diving
-	PlayerMovementComponent->StopDive();
-	
-	//stop sliding
-	PlayerMovementComponent->StopSlide();
+	//release the slide button (the movement component stops diving and sliding)
+	PlayerMovementComponent->bWantsToSlide = false;
 }
 
 void APlayerCharacter::DoJump(const FInputActionValue& Value)
@@ -0,0 +1,92 @@
+#include "Player/PlayerRewindBuffer.h"
+
+void FPlayerRewindBuffer::SetCapacity(const int32 NumFrames, const int32 NumPivots)
+{
+	//allocate the rings (a frame can have up to 255 pivots, so the pivot ring has to fit at least that many)
+	Frames.SetNumZeroed(FMath::Max(NumFrames, 0));
+	Pivots.SetNum(NumFrames > 0 ? FMath::Max(NumPivots, static_cast<int32>(MAX_uint8)) : 0);
+
+	//clear the buffer
+	Reset();
+}
+
+void FPlayerRewindBuffer::Reset()
+{
+	Head = 0;
+	Count = 0;
+	PivotCount = 0;
+}
+
+FPlayerRewindFrame& FPlayerRewindBuffer::Push(const int32 NumPivots, FPlayerRewindPivot*& OutPivots)
+{
+	//assert that we have frames to write to
+	check(Frames.Num() > 0);
+
+	//get the frame to write to
+	FPlayerRewindFrame& Frame = Frames[Head];
+
+	//advance the head (wrapping around to overwrite the oldest frame)
+	Head = (Head + 1) % Frames.Num();
+
+	//update the number of valid frames
+	Count = FMath::Min(Count + 1, Frames.Num());
+
+	//check if the frame has no pivots
+	Frame.NumPivots = static_cast<uint8>(FMath::Clamp(NumPivots, 0, static_cast<int32>(MAX_uint8)));
+	if (Frame.NumPivots == 0)
+	{
+		Frame.FirstPivot = PivotCount;
+		OutPivots = nullptr;
+		return Frame;
+	}
+
+	//get the first pivot slot, skipping to the start of the ring if the pivots don't fit before its end (so they're contiguous)
+	const uint32 PivotCapacity = static_cast<uint32>(Pivots.Num());
+	uint32 FirstPivot = PivotCount;
+	if (const uint32 Offset = FirstPivot % PivotCapacity; Offset + Frame.NumPivots > PivotCapacity)
+	{
+		FirstPivot += PivotCapacity - Offset;
+	}
+
+	//hand out the pivot slots
+	Frame.FirstPivot = FirstPivot;
+	PivotCount = FirstPivot + Frame.NumPivots;
+	OutPivots = &Pivots[FirstPivot % PivotCapacity];
+
+	return Frame;
+}
+
+const FPlayerRewindFrame* FPlayerRewindBuffer::GetFromNewest(const int32 Offset) const
+{
+	//check if the offset is out of range
+	if (Offset < 0 || Offset >= Count)
+	{
+		return nullptr;
+	}
+
+	//get the index of the frame (the newest frame is right behind the head)
+	const int32 Index = (Head - 1 - Offset + Frames.Num()) % Frames.Num();
+
+	return &Frames[Index];
+}
+
+const FPlayerRewindPivot* FPlayerRewindBuffer::GetPivots(const FPlayerRewindFrame& Frame) const
+{
+	//check if the frame has no pivots or later frames have written over them
+	if (Frame.NumPivots == 0 || PivotCount - Frame.FirstPivot > static_cast<uint32>(Pivots.Num()))
+	{
+		return nullptr;
+	}
+
+	return &Pivots[Frame.FirstPivot % static_cast<uint32>(Pivots.Num())];
+}
+
+void FPlayerRewindBuffer::DiscardNewest(const int32 NumFrames)
+{
+	//get the number of frames to drop
+	const int32 NumToDrop = FMath::Clamp(NumFrames, 0, Count);
+
+	//move the head back over them
+	Head = (Head - NumToDrop + Frames.Num()) % FMath::Max(Frames.Num(), 1);
+	Count -= NumToDrop;
+}
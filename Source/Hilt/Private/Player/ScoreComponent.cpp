@@ -5,8 +5,12 @@
 
 #include "Components/PlayerMovementComponent.h"
 #include "Components/GrapplingHook/GrapplingComponent.h"
+#include "Core/HiltSimulationSubsystem.h"
+#include "Core/Math/BakedCurve.h"
 #include "Player/PlayerCharacter.h"
 
+const FScoreValues UScoreComponent::DefaultScoreValues;
+
 // Sets default values for this component's properties
 UScoreComponent::UScoreComponent()
 {
@@ -21,6 +25,12 @@ void UScoreComponent::BeginPlay()
 
 	//get the owner as a player character
 	PlayerCharacter = Cast<APlayerCharacter>(GetOwner());
+
+	//get the starting score tier
+	UpdateScoreTier();
+
+	//bake the degradation curve and the curves of every score value
+	HiltCurves::BakeReferencedCurves(this);
 }
 
 void UScoreComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
@@ -29,20 +39,13 @@ void UScoreComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActor
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
 	//check if the score degradation curve is valid and the last score gain time + the score decay delay is less than the current time and that we're not falling and we're walking
-	if (ScoreDegradationCurve && LastScoreGainTime + GetCurrentScoreValues().ScoreDecayDelay < GetWorld()->GetTimeSeconds() && bShouldDegrade)
+	if (ScoreDegradationCurve && LastScoreGainTime + GetScoreValues().ScoreDecayDelay < UHiltSimulationSubsystem::GetGameplayTime(this) && bShouldDegrade)
 	{
 		//get the degradation value from the curve
-		const float DegradationValue = ScoreDegradationCurve->GetFloatValue(Score / ScoreValues.Num());
+		const float DegradationValue = HiltCurves::Evaluate(ScoreDegradationCurve, Score / ScoreValues.Num());
 
-		//degrade the score
-		Score -= DegradationValue * DeltaTime;
-
-		//check if the score is less than 0
-		if (Score < 0)
-		{
-			//set the score to 0
-			Score = 0;
-		}
+		//degrade the score (not going below 0)
+		SetScore(FMath::Max(Score - DegradationValue * DeltaTime, 0.f));
 	}
 }
 
@@ -52,10 +55,10 @@ void UScoreComponent::AddScore(const float Value)
 	//const float DefaultScoreAdditionValue = Score + Value;
 
 	//apply the score addition value
-	Score = FMath::Clamp(Score + Value * GetCurrentScoreValues().ScoreGainMultiplier, 0.f, ScoreValues.Num() - 0.01);
+	SetScore(FMath::Clamp(Score + Value * GetScoreValues().ScoreGainMultiplier, 0.f, ScoreValues.Num() - 0.01));
 
 	//set the last score gain time
-	LastScoreGainTime = GetWorld()->GetTimeSeconds();
+	LastScoreGainTime = UHiltSimulationSubsystem::GetGameplayTime(this);
 
 	//check if the value is greater than 0
 	if (Value > 0)
@@ -71,7 +74,7 @@ void UScoreComponent::SubtractScore(const float Value)
 	//const float DefaultScoreSubtractionValue = Score - Value;
 	//
 	//apply the score subtraction value
-	Score = FMath::Clamp(Score - Value * GetCurrentScoreValues().ScoreLossMultiplier, 0.f, ScoreValues.Num() - 0.01);
+	SetScore(FMath::Clamp(Score - Value * GetScoreValues().ScoreLossMultiplier, 0.f, ScoreValues.Num() - 0.01));
 
 	//set the last score gain time to -infinity
 	LastScoreGainTime = -INFINITY;
@@ -86,7 +89,12 @@ void UScoreComponent::SubtractScore(const float Value)
 
 void UScoreComponent::ResetScore()
 {
-	Score = 0;
+	SetScore(0);
+}
+
+void UScoreComponent::RestoreScore(const float NewScore)
+{
+	SetScore(NewScore);
 }
 
 void UScoreComponent::StartDegredationTimer()
@@ -94,7 +102,7 @@ void UScoreComponent::StartDegredationTimer()
 	//check if we're already degrading
 	if (!bShouldDegrade)
 	{
-		LastScoreGainTime = GetWorld()->GetTimeSeconds();
+		LastScoreGainTime = UHiltSimulationSubsystem::GetGameplayTime(this);
 		bShouldDegrade = true;
 	}
 }
@@ -110,7 +118,35 @@ void UScoreComponent::StopDegredationTimer()
 
 FScoreValues UScoreComponent::GetCurrentScoreValues() const
 {
-	//return the score values at the current score
-	return ScoreValues[FMath::Min(ScoreValues.Num() - 1, FMath::Floor(Score))];
+	//return the score values of the current score tier
+	return GetScoreValues();
+}
+
+void UScoreComponent::SetScore(const float NewScore)
+{
+	//set the score
+	Score = NewScore;
+
+	//update the score tier
+	UpdateScoreTier();
+}
+
+void UScoreComponent::UpdateScoreTier()
+{
+	//get the score tier of the current score
+	const int32 NewTier = FMath::Clamp(FMath::FloorToInt32(Score), 0, FMath::Max(ScoreValues.Num() - 1, 0));
+
+	//check if the score tier didn't change
+	if (NewTier == ScoreTier)
+	{
+		return;
+	}
+
+	//store the old score tier and set the new one
+	const int32 OldTier = ScoreTier;
+	ScoreTier = NewTier;
+
+	//broadcast the score tier change
+	OnScoreTierChanged.Broadcast(NewTier, OldTier);
 }
 
@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GrappleVisibilityBakeCommandlet.generated.h"
+
+struct FGrappleVisibilityHeader;
+
+/**
+ * Bakes the grapple visibility of a level for UGrappleVisibilitySubsystem.
+ * Splits the bounds of the level's static geometry into a coarse grid and traces a few rays through every octahedral direction bin from the center and corners of each cell.
+ * The farthest static hit of each bin is stored as a byte (0 = nothing within the max grapple distance) in a binary file that is memory-mapped at runtime.
+ *
+ * Usage: UnrealEditor-Cmd Hilt.uproject -run=GrappleVisibilityBake -Map=/Game/Levels/Map_Pacer [-CellSize=2000] [-MaxDistance=<cm>] [-RaysPerBinSide=2] [-Output=<file>]
+ */
+UCLASS()
+class UGrappleVisibilityBakeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	//constructor
+	UGrappleVisibilityBakeCommandlet();
+
+	//overrides
+	virtual int32 Main(const FString& Params) override;
+
+private:
+
+	//the size of the grid cells
+	float CellSize = 2000.f;
+
+	//the max distance to trace (defaults to the grappling component's max grapple distance)
+	float MaxDistance = 0.f;
+
+	//the number of rays per side of each direction bin (RaysPerBinSide^2 rays per bin per sample point)
+	int32 RaysPerBinSide = 2;
+
+	//the collision channel to trace on (defaults to the rope component's collision channel)
+	TEnumAsByte<ECollisionChannel> CollisionChannel = ECC_Visibility;
+
+	//function to load a level and initialize it for scene queries
+	static UWorld* LoadWorld(const FString& MapPath);
+
+	//function to unload a level loaded with LoadWorld
+	static void UnloadWorld(UWorld* World);
+
+	//function to get the bounds of the static geometry that blocks the collision channel
+	FBox GetStaticBounds(UWorld* World) const;
+
+	//function to bake the direction bins of one cell
+	void BakeCell(const UWorld* World, const FVector& CellMin, const FCollisionQueryParams& QueryParams, uint8* OutBins) const;
+
+	//function to write the header and the cell data to a file
+	static bool WriteFile(const FString& FilePath, const FGrappleVisibilityHeader& Header, const TArray<uint8>& CellData);
+};
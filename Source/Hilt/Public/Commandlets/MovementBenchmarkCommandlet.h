@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "Core/HiltSimulationSubsystem.h"
+#include "MovementBenchmarkCommandlet.generated.h"
+
+class APlayerCharacter;
+
+//struct for one line of a movement benchmark input script
+struct FMovementScriptLine
+{
+	//the number of steps the line is held for
+	int32 NumSteps = 1;
+
+	//the wasd direction held during the line
+	FVector2D MoveDirection = FVector2D::ZeroVector;
+
+	//the buttons held during the line (EHiltInputButtons, grapple and fire are pressed when they start being held)
+	uint8 Buttons = 0;
+
+	//how fast the control rotation turns during the line (in degrees per second)
+	float YawRate = 0;
+	float PitchRate = 0;
+};
+
+//struct for the cost of one part of the player's simulation over a benchmark run
+struct FMovementBenchmarkTiming
+{
+	//the name of the part
+	FString Name;
+
+	//the total and worst time spent in the part (in seconds)
+	double TotalSeconds = 0;
+	double MaxSeconds = 0;
+
+	//the total number of scene queries issued by the part
+	int64 SceneQueries = 0;
+
+	//function to add one step's time and scene queries
+	void Add(double Seconds, int32 NumSceneQueries);
+};
+
+/**
+ * Headless player movement benchmark.
+ * Loads a test map, spawns the player and drives it with a recorded input file (see UHiltSimulationSubsystem) or a text input script for a fixed number of steps as fast as possible.
+ * Times the world tick and the movement, rope, grapple and score components separately, counts their scene queries and writes the results to a CSV file.
+ * The default output file includes the process id so several instances can run in parallel.
+ *
+ * Script lines are "<steps> [W] [A] [S] [D] [Jump] [Slide] [Grapple] [Fire] [Yaw=<deg/s>] [Pitch=<deg/s>]" (# starts a comment, sliding in the air dives).
+ *
+ * Usage: UnrealEditor-Cmd Hilt.uproject -run=MovementBenchmark -nullrhi -Map=/Game/TestMaps/<map> [-Input=<hrec> | -Script=<txt>] [-Frames=3600] [-StepRate=120] [-PlayerClass=<class>] [-Output=<csv>]
+ */
+UCLASS()
+class UMovementBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	//constructor
+	UMovementBenchmarkCommandlet();
+
+	//overrides
+	virtual int32 Main(const FString& Params) override;
+
+private:
+
+	//the number of steps to simulate
+	int32 NumFrames = 3600;
+
+	//the number of steps per second to simulate with
+	int32 StepRate = 120;
+
+	//function to load a map into a game world
+	static UWorld* LoadWorld(const FString& MapPath);
+
+	//function to parse an input script into lines
+	static bool ParseScript(const TArray<FString>& ScriptLines, TArray<FMovementScriptLine>& OutLines);
+
+	//function to make the input frame of a script step by driving the player's input functions
+	static void MakeScriptFrame(APlayerCharacter* Player, const FMovementScriptLine& Line, uint8 PreviousButtons, float DeltaTime, FRotator& InOutControlRotation, FHiltInputFrame& OutFrame);
+
+	//function to time one component tick
+	static void TimeComponentTick(UActorComponent* Component, float DeltaTime, FMovementBenchmarkTiming& Timing);
+
+	//function to write the results to a CSV file
+	bool WriteResults(const FString& FilePath, const FString& MapPath, const FString& InputName, const TArray<FMovementBenchmarkTiming>& Timings, double WallSeconds) const;
+};
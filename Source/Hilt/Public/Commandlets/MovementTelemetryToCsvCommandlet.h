@@ -0,0 +1,26 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MovementTelemetryToCsvCommandlet.generated.h"
+
+/**
+ * Converts a binary movement telemetry file (see FMovementTelemetryRecord for the schema) to a CSV file with one row per frame.
+ *
+ * Usage: UnrealEditor-Cmd Hilt.uproject -run=MovementTelemetryToCsv -Input=<htel> [-Output=<csv>]
+ */
+UCLASS()
+class UMovementTelemetryToCsvCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	//constructor
+	UMovementTelemetryToCsvCommandlet();
+
+	//overrides
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "RopeBenchmarkCommandlet.generated.h"
+
+//struct for the result of one rope benchmark run
+struct FRopeBenchmarkResult
+{
+	//the name of the geometry scenario
+	FString Scenario;
+
+	//the rope settings used for the run
+	int32 NumVerletPoints = 0;
+	int32 NumConstraintIterations = 0;
+	bool bUseVerletIntegration = false;
+
+	//the average and worst time spent in the rope tick (in milliseconds)
+	double MsPerTick = 0;
+	double MaxMsPerTick = 0;
+
+	//the average number of scene queries issued per rope tick
+	double SceneQueriesPerTick = 0;
+
+	//the average number of heap allocations made per rope tick (counted by HiltProfiling::FScopedAllocationCounter)
+	double AllocationsPerTick = 0;
+
+	//the memory reserved by the rope's arrays at the end of the run (in bytes)
+	int64 ReservedBytes = 0;
+
+	//function to get the key used to match this result against the baseline
+	FString GetKey() const;
+};
+
+/**
+ * Headless rope performance benchmark.
+ * Spawns a rope in generated geometry scenarios, sweeps the rope settings and writes the per-tick cost to a CSV file.
+ * Fails if any run is slower, issues more scene queries or allocates more than the baseline by more than the threshold, or if the baseline has no entry for a run (timings are machine specific, capture the baseline on the reference machine with -UpdateBaseline).
+ * If there's no baseline file yet, the run is written as the baseline with a warning and the gate passes.
+ *
+ * Usage: UnrealEditor-Cmd Hilt.uproject -run=RopeBenchmark -nullrhi [-Ticks=240] [-Output=<csv>] [-Baseline=<csv>] [-Threshold=<percent>] [-UpdateBaseline]
+ */
+UCLASS()
+class URopeBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	//constructor
+	URopeBenchmarkCommandlet();
+
+	//overrides
+	virtual int32 Main(const FString& Params) override;
+
+private:
+
+	//the number of ticks to simulate per run
+	int32 NumTicks = 240;
+
+	//the fixed delta time to simulate each tick with
+	float DeltaTime = 1.f / 60.f;
+
+	//function to spawn the geometry for a scenario, returns the location the rope should be grappled to
+	static FVector SpawnScenario(UWorld* World, const FString& Scenario, AActor*& OutMovingActor);
+
+	//function to get where the rope's owner should be at a given time in a scenario
+	static FVector GetOwnerLocation(const FString& Scenario, float Time);
+
+	//function to spawn a box of the given size at the given location
+	static AActor* SpawnBox(UWorld* World, const FVector& Location, const FVector& Size, bool bMovable);
+
+	//function to run one benchmark configuration
+	FRopeBenchmarkResult RunBenchmark(const FString& Scenario, int32 NumVerletPoints, int32 NumConstraintIterations, bool bUseVerletIntegration) const;
+
+	//function to write the results to a CSV file
+	static bool WriteResults(const FString& FilePath, const TArray<FRopeBenchmarkResult>& Results);
+
+	//function to read the results from a baseline CSV file (keyed by FRopeBenchmarkResult::GetKey)
+	static bool ReadBaseline(const FString& FilePath, TMap<FString, FRopeBenchmarkResult>& OutBaseline);
+
+	//function to check if a per-tick value regressed from the baseline by more than the threshold (in percent)
+	static bool IsRegression(double Value, double BaselineValue, float Threshold);
+};
@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/GrapplingHook/GrapplingComponent.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GrappleTargetSubsystem.generated.h"
+
+class UGrappleableComponent;
+
+/**
+ * World subsystem that keeps every grappleable component in a spatial hash so grapple targets can be found without scene queries.
+ * Grappleable components register themselves when they're registered with the world, the hash is updated every tick for targets that moved.
+ */
+UCLASS()
+class UGrappleTargetSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	//the size of the spatial hash cells
+	static constexpr float CellSize = 2000.f;
+
+	//function to add a grappleable component to the hash
+	void RegisterTarget(UGrappleableComponent* Target);
+
+	//function to remove a grappleable component from the hash
+	void UnregisterTarget(UGrappleableComponent* Target);
+
+	//function to find the best target inside a view cone, ranked by angle from the view direction and distance (AngleWeight = 1 ranks only by angle, 0 only by distance)
+	UGrappleableComponent* FindBestTarget(const FVector& ViewLocation, const FVector& ViewDirection, float MaxDistance, float MaxAngleDegrees, float AngleWeight, const AActor* IgnoredActor = nullptr) const;
+
+	//function to get the number of registered targets
+	int32 GetNumTargets() const { return TargetCells.Num(); }
+
+	//function to get the current grapple values of a primitive component (finds the grappleable component through the registered targets instead of iterating the owner's components)
+	FGrappleableMetadata GetMetadata(const UPrimitiveComponent* Primitive) const;
+
+	//function to get the grappleable component of an actor (nullptr if the actor isn't grappleable)
+	UGrappleableComponent* FindGrappleable(const AActor* Actor) const { return Actor ? TargetOwners.FindRef(Actor) : nullptr; }
+
+	//function to get the grappleable component of a hit (nullptr if the hit actor isn't grappleable)
+	UGrappleableComponent* FindGrappleable(const FHitResult& Hit) const { return FindGrappleable(Hit.GetActor()); }
+
+	//function to copy the values of a grappleable component into a metadata entry
+	static void FillMetadata(const UGrappleableComponent* Target, FGrappleableMetadata& OutMetadata);
+
+	//overrides
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+
+protected:
+
+	//overrides
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+
+	//the targets in each spatial hash cell (targets unregister themselves before they're destroyed, so the raw pointers stay valid)
+	TMap<FIntVector, TArray<UGrappleableComponent*>> Cells;
+
+	//the cell each registered target is in
+	TMap<UGrappleableComponent*, FIntVector> TargetCells;
+
+	//the grappleable component of every actor with a registered target (removed when the target unregisters, so only grappleable actors are ever in here)
+	TMap<const AActor*, UGrappleableComponent*> TargetOwners;
+
+	//function to get the cell a location is in
+	static FIntVector GetCell(const FVector& Location);
+
+	//function to remove a target from a cell
+	void RemoveFromCell(UGrappleableComponent* Target, const FIntVector& Cell);
+
+	//function to score a target for the view cone (lower is better), returns false if the target is outside the cone
+	static bool ScoreTarget(const UGrappleableComponent* Target, const FVector& ViewLocation, const FVector& ViewDirection, float MaxDistance, float MinCosAngle, float MaxAngleRadians, float AngleWeight, const AActor* IgnoredActor, float& OutScore);
+};
@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/MappedFileHandle.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GrappleVisibilitySubsystem.generated.h"
+
+//the header at the start of a baked grapple visibility file (followed by NumBins bytes per cell, x fastest then y then z)
+struct FGrappleVisibilityHeader
+{
+	//the magic number and version of the file
+	uint32 Magic = 0;
+	uint32 Version = 0;
+
+	//the world location of the min corner of the grid
+	FVector3f Origin = FVector3f::ZeroVector;
+
+	//the size of a grid cell
+	float CellSize = 0;
+
+	//the number of cells along each axis
+	FIntVector Dimensions = FIntVector::ZeroValue;
+
+	//the max grapple distance the file was baked with
+	float MaxDistance = 0;
+
+	//the number of direction bins per cell
+	uint32 NumBins = 0;
+};
+
+/**
+ * World subsystem that memory-maps the baked grapple visibility of the current level (see UGrappleVisibilityBakeCommandlet).
+ * For every cell of a coarse grid the file stores, per octahedral direction bin, the farthest static surface that was hit from the cell (0 = no static surface in range).
+ * The grapple uses it to reject aims at nothing and to shorten its traces without scene queries. Movable geometry isn't baked.
+ */
+UCLASS()
+class UGrappleVisibilitySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	//the magic number and version of the baked files
+	static constexpr uint32 FileMagic = 0x56474748; // "HGGV"
+	static constexpr uint32 FileVersion = 1;
+
+	//the number of direction bins along each side of the octahedral map
+	static constexpr int32 BinsPerSide = 16;
+	static constexpr int32 NumBins = BinsPerSide * BinsPerSide;
+
+	//function to get the path of the baked file for a level
+	static FString GetBakePath(const FString& LevelPackageName);
+
+	//function to get the direction bin of a direction
+	static int32 DirectionToBin(const FVector& Direction);
+
+	//function to get a direction inside a bin (the offsets are in bins from the bin center, -0.5 to 0.5)
+	static FVector BinToDirection(int32 Bin, float OffsetU = 0, float OffsetV = 0);
+
+	//function to get the farthest a grappleable static surface can be from a location in a direction (over the neighbouring direction bins, plus a margin), returns false if there's no baked data for the query (0 = nothing in range or the neighbourhood isn't fully blocked)
+	bool GetMaxVisibleDistance(const FVector& Location, const FVector& Direction, float MaxDistance, float& OutDistance) const;
+
+	//whether or not baked data is loaded for this world
+	bool HasData() const { return Header != nullptr; }
+
+	//overrides
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+protected:
+
+	//overrides
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+
+	//the mapped file and region (the region has to be released before the file)
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	//the header and cell data inside the mapped region
+	const FGrappleVisibilityHeader* Header = nullptr;
+	const uint8* CellData = nullptr;
+
+	//function to release the mapped file
+	void Unmap();
+};
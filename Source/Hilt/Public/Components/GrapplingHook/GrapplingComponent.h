@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "Core/Math/InterpShorthand.h"
+#include "Player/ScoreComponent.h"
+#include "Tasks/Task.h"
 #include "GrapplingComponent.generated.h"
 
 //enum for different grappling modes based of player input
@@ -38,6 +40,128 @@ struct FGrappleInterpStruct
 	FGrappleInterpStruct(float InPullSpeed, float InPullAccel, EInterpToTargetType InInterpMode);
 };
 
+//struct for the values the grapple code reads many times per tick (resolved once per tick after the player's movement, the score values only when the score tier changes)
+USTRUCT(BlueprintType)
+struct FGrappleFrameContext
+{
+	GENERATED_BODY()
+
+	//the score values of the current score tier
+	UPROPERTY(BlueprintReadOnly)
+	FScoreValues ScoreValues;
+
+	//the location of the owner
+	UPROPERTY(BlueprintReadOnly)
+	FVector OwnerLocation = FVector::ZeroVector;
+
+	//the velocity of the owner
+	UPROPERTY(BlueprintReadOnly)
+	FVector Velocity = FVector::ZeroVector;
+
+	//the normalized velocity of the owner
+	UPROPERTY(BlueprintReadOnly)
+	FVector VelocityDirection = FVector::ZeroVector;
+
+	//the first rope point after the owner (the point the rope pulls towards), the owner's location when not grappling
+	UPROPERTY(BlueprintReadOnly)
+	FVector PivotLocation = FVector::ZeroVector;
+
+	//the end of the rope, the owner's location when not grappling
+	UPROPERTY(BlueprintReadOnly)
+	FVector RopeEnd = FVector::ZeroVector;
+
+	//the normalized direction of the rope from the owner
+	UPROPERTY(BlueprintReadOnly)
+	FVector GrappleDirection = FVector::ZeroVector;
+
+	//the distance from the owner to the end of the rope divided by the max grapple distance (clamped to 0-1)
+	UPROPERTY(BlueprintReadOnly)
+	float DistanceRatio = 0;
+
+	//the score adjusted speed limit of the movement component
+	UPROPERTY(BlueprintReadOnly)
+	float CurrentSpeedLimit = 1;
+
+	//the speed velocities are clamped to (the lower of the current speed limit and the max speed)
+	UPROPERTY(BlueprintReadOnly)
+	float SpeedLimit = 0;
+};
+
+//the grapple values of a primitive component, cached so hits can be resolved without iterating the components of the hit actor
+struct FGrappleableMetadata
+{
+	//the grappleable component of the primitive's owner (nullptr if the owner isn't grappleable)
+	class UGrappleableComponent* Grappleable = nullptr;
+
+	//the interp struct for the player when grappling to the grappleable and whether or not to use it
+	FGrappleInterpStruct InterpStructPlayer = FGrappleInterpStruct();
+	bool bUseGrappleInterpStruct = false;
+
+	//whether or not the player can change grapple modes when grappling to the grappleable
+	bool bCanChangeGrappleMode = true;
+
+	//whether or not the player should use normal movement when grappling to the grappleable
+	bool bNormalMovement = false;
+
+	//the multiplier for the grapple reel force applied to the player
+	float ReelForceMultiplierPlayer = 1;
+
+	//the max speed to use for the player when grappling to the grappleable (only used if positive)
+	float MaxSpeedPlayer = -1;
+};
+
+//struct for the parameters of a simulated grapple (a copy of everything the pull math reads, so the simulation has no side effects and can run on a worker thread)
+struct FGrappleSimParams
+{
+	//the point the rope pulls towards (the first rope point after the player)
+	FVector PivotLocation = FVector::ZeroVector;
+
+	//the end of the rope (used for the distance curve and the stop distance)
+	FVector RopeEnd = FVector::ZeroVector;
+
+	//the grapple mode to simulate
+	TEnumAsByte<EGrapplingMode> GrappleMode = AddToVelocity;
+
+	//the interp struct to use in the interp velocity mode
+	FGrappleInterpStruct InterpStruct;
+
+	//the pull speed to use in the add to velocity mode
+	float PullSpeed = 0;
+
+	//the multiplier applied to the player's velocity by the grappleable component (1 if there is none)
+	float ReelForceMultiplierPlayer = 1;
+
+	//the speed the velocity is clamped to
+	float SpeedLimit = 0;
+
+	//the score adjusted speed limit (used to normalize the velocity for the velocity curve)
+	float CurrentSpeedLimit = 1;
+
+	//the max grapple distance (used to normalize the distance for the distance curve)
+	float MaxGrappleDistance = 1;
+
+	//the distance to the rope end at which the grapple stops
+	float StopDistance = 0;
+
+	//the gravity applied while grappling (0 if gravity is disabled when grappling)
+	float GravityZ = 0;
+
+	//the baked score curves used by the add to velocity mode (baked tables can be read from the preview's worker thread)
+	const struct FBakedCurveFloat* AngleCurve = nullptr;
+	const struct FBakedCurveFloat* DistanceCurve = nullptr;
+	const struct FBakedCurveFloat* VelocityCurve = nullptr;
+};
+
+//struct for the scratch state of a simulated grapple
+struct FGrappleSimState
+{
+	//the simulated location of the player
+	FVector Location = FVector::ZeroVector;
+
+	//the simulated velocity of the player
+	FVector Velocity = FVector::ZeroVector;
+};
+
 UCLASS()
 class UGrapplingComponent : public UActorComponent
 {
@@ -57,6 +181,9 @@ public:
 	UPROPERTY(BlueprintReadOnly)
 	class UGrappleableComponent* GrappleableComponent = nullptr;
 
+	//the cached grapple values of the grappleable component (read every tick instead of the component)
+	FGrappleableMetadata GrappleableMetadata;
+
 	//start grappling event
 	UPROPERTY(BlueprintAssignable, Category = "Events")
 	FOnStartGrapple OnStartGrapple;
@@ -109,6 +236,34 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "CanGrapple")
 	float GrappleCheckWiggleRoom = 1000;
 
+	//whether or not to reuse the last async availability result when starting a grapple (skips the grapple trace and starts pulling on the input frame)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "CanGrapple")
+	bool bUseSameFrameGrapple = true;
+
+	//the max angle (in degrees) the aim can have moved away from the availability hit for it to still be used
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "CanGrapple", meta = (ClampMin = 0, ClampMax = 45))
+	float AvailabilityRevalidateAngle = 2;
+
+	//the max age (in frames) of the availability result for it to still be used
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "CanGrapple", meta = (ClampMin = 0))
+	int32 MaxAvailabilityResultAge = 2;
+
+	//whether or not to use the baked grapple visibility of the level to shorten grapple traces (see UGrappleVisibilityBakeCommandlet)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "CanGrapple")
+	bool bUseBakedVisibility = true;
+
+	//whether or not to use aim assist when the grapple line trace doesn't hit anything (the sphere trace is still used when the aim assist doesn't find a target)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AimAssist")
+	bool bUseAimAssist = true;
+
+	//the max angle (in degrees) between the aim direction and a grappleable target for the aim assist to pick it
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AimAssist", meta = (ClampMin = 0, ClampMax = 89))
+	float AimAssistAngle = 10;
+
+	//how much the aim assist prefers targets close to the aim direction over targets close to the player (1 = only angle, 0 = only distance)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AimAssist", meta = (ClampMin = 0, ClampMax = 1))
+	float AimAssistAngleWeight = 0.75f;
+
 	//the float curve to use for calculating the score to give from the grapple (0 = no time, > 0 = time)
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grappling")
 	UCurveFloat* GrappleScoreCurve = nullptr;
@@ -117,6 +272,14 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grappling")
 	float GrappleFriction = 0.5f;
 
+	//the fixed time step the pull force is applied with (so the pull is the same at any frame rate)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grappling", meta = (ClampMin = 0.001))
+	float GrappleFixedTimeStep = 1.f / 120.f;
+
+	//the max number of fixed steps to apply in a single frame (time beyond this is dropped to avoid spiralling on long frames)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grappling", meta = (ClampMin = 1))
+	int32 MaxGrappleSubsteps = 8;
+
 	//the distance threshold to use when checking if we should stop grappling
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grappling")
 	float GrappleStopDistance = 100;
@@ -145,10 +308,14 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grappling")
 	float GrappleScoreDecayStopDelay = 0.5f;
 
-	//whether or not we can grapple right now
+	//whether or not we can grapple right now (updated from an async trace, so it lags one frame behind the aim)
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "CanGrapple")
 	bool CanGrappleVar = false;
 
+	//the values resolved for this tick (updated at the start of the tick and when a grapple starts)
+	UPROPERTY(BlueprintReadOnly)
+	FGrappleFrameContext FrameContext;
+
 	//the amount of pending score to give from the grapple
 	UPROPERTY(BlueprintReadOnly)
 	float PendingScore = 0;
@@ -168,10 +335,30 @@ public:
 	//storage for the grapple hit(s) we have
 	TArray<FHitResult> GrappleHits;
 
+	//whether or not to predict the path of the grapple while aiming or grappling
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Preview")
+	bool bShowTrajectoryPreview = false;
+
+	//the number of steps to simulate for the trajectory preview
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Preview", meta = (ClampMin = 1))
+	int32 PreviewNumSteps = 120;
+
+	//the time step to use for the trajectory preview
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Preview", meta = (ClampMin = 0.001))
+	float PreviewTimeStep = 1.f / 60.f;
+
+	//the predicted path of the grapple (updated from a worker thread, lags a frame behind)
+	UPROPERTY(BlueprintReadOnly, Category = "Preview")
+	TArray<FVector> PreviewPath;
+
+	//storage for the grapple hit(s) from the last completed availability trace (used to update CanGrappleVar)
+	TArray<FHitResult> AvailabilityHits;
+
 	//constructor
 	UGrapplingComponent();
 
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
 	//start grappling function
@@ -210,18 +397,85 @@ private:
 	//function to do the grapple trace with a given max distance
 	void DoGrappleTrace(float MaxDistance, bool DoSphereTrace);
 
-	//function to check for force modifiers based on the grappleable component of the target we're grappling to
-	void CheckTargetForceModifiers(FVector& BaseVel, float DeltaTime) const;
+	//function to get the start and end of the grapple trace from the player's view point
+	void GetGrappleTraceStartEnd(float MaxDistance, FVector& OutStart, FVector& OutEnd) const;
+
+	//function to filter the hits of a grapple trace down to the ones we can grapple to
+	void FilterGrappleHits(const TArray<FHitResult>& Hits, TArray<FHitResult>& OutHits) const;
+
+	//function to shorten a grapple trace to the farthest static surface around it in the baked visibility of the level (never rejects a trace, only shortens it when every neighbouring direction is blocked)
+	void ApplyBakedVisibility(const FVector& Start, FVector& End) const;
+
+	//function to find the best grappleable target near the aim direction and confirm it with a single line trace
+	bool FindAimAssistHit(FHitResult& OutHit) const;
+
+	//function to start the async availability trace (the result is used to update CanGrappleVar next frame)
+	void RequestAvailabilityTrace();
+
+	//function called when the async availability trace is done
+	void OnAvailabilityTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	//the delegate called when the async availability trace is done
+	FTraceDelegate AvailabilityTraceDelegate;
+
+	//the frame the availability hits were last updated on
+	uint64 AvailabilityResultFrame = 0;
+
+	//function to get the availability hit if it's still valid for where the player is aiming now (no trace)
+	bool GetValidAvailabilityHit(FHitResult& OutHit) const;
+
+	//function to apply the first pull step right after the grapple starts (so this frame's movement already uses it)
+	void ApplyFirstPullStep();
+
+	//function to check for force modifiers based on the grappleable component of the target we're grappling to (steps the target's pull velocity, which is applied once the steps are done)
+	void CheckTargetForceModifiers(FVector& BaseVel, float DeltaTime);
+
+	//function to start stepping the pull velocity of the grappled target from its current velocity
+	void BeginTargetPullSteps();
+
+	//function to apply the stepped pull velocity to the grappled target
+	void EndTargetPullSteps() const;
+
+	//the velocity of the grappled target, stepped along with the pull force (physics targets only read their velocity once per frame)
+	FVector TargetPullVelocity = FVector::ZeroVector;
 
 	//function to check for force modifiers based on the grappleable component and the current grappling mode
 	void CheckTargetPullSpeedModifiers(float& PullSpeed) const;
 
+	//function to resolve the values in the frame context
+	void UpdateFrameContext();
+
 	//function to apply the pull force to the player
 	void ApplyPullForce(float DeltaTime);
 
+	//function to apply the pull force in fixed steps for the time that passed this frame (each step pulls along the rope from where the previous step moved the owner)
+	void ApplyFixedStepPullForce(float DeltaTime);
+
+	//the frame time that hasn't been simulated by a pull step yet (carried over to the next frame, negative after the first pull step, which is applied ahead of time)
+	float PullTimeAccumulator = 0;
+
+	//function to swap in the last preview path and start simulating the next one
+	void UpdateTrajectoryPreview();
+
+	//the preview path being written by the worker thread
+	TArray<FVector> PreviewBackBuffer;
+
+	//the task simulating the preview path
+	UE::Tasks::TTask<void> PreviewTask;
+
+	//the handle of the pre garbage collection delegate (the preview reads baked curve tables, which are freed after garbage collection)
+	FDelegateHandle PreGarbageCollectHandle;
+
+	//function to wait for the preview simulation to finish
+	void WaitForPreviewTask();
+
 	UFUNCTION()
 	void OnGrappleTargetDestroyed(AActor* DestroyedActor);
 
+	//function called when the player's score tier changes to recache the score values in the frame context
+	UFUNCTION()
+	void OnScoreTierChanged(int32 NewTier, int32 OldTier);
+
 public:
 	/**
 	 * Getters
@@ -247,6 +501,25 @@ public:
 	UFUNCTION()
 	static float GetAbsoluteGrappleDotProduct(FVector GrappleVelocity);
 
+	//function to fill the simulation params from the current state of the grapple, pulling towards the given pivot
+	void GetSimParams(const FVector& PivotLocation, const FVector& RopeEnd, FGrappleSimParams& OutParams) const;
+
+	//function to predict the path of a grapple to the target location (or along the current rope if we're grappling), reuses the array's allocation
+	UFUNCTION(BlueprintCallable)
+	void PredictGrapplePath(FVector TargetLocation, int32 NumSteps, float TimeStep, TArray<FVector>& OutPath) const;
+
+	//function to calculate the velocity added by the pull in the add to velocity mode (before the grappleable modifiers and the speed limit)
+	static FVector CalculatePullImpulse(const FGrappleSimParams& Params, const FVector& Location, const FVector& Velocity, const FVector& Direction, float DeltaTime);
+
+	//function to calculate the interpolated velocity in the interp velocity mode (before the speed limit)
+	static FVector CalculateInterpVelocity(const FGrappleInterpStruct& InterpStruct, const FVector& Velocity, const FVector& Direction, float DeltaTime);
+
+	//function to advance a simulated grapple by one step, returns false once the simulated player reaches the end of the rope
+	static bool SimulatePullStep(const FGrappleSimParams& Params, FGrappleSimState& State, float DeltaTime);
+
+	//function to simulate a grapple for a number of steps and write the simulated locations (doesn't allocate once the array has grown)
+	static void SimulateGrapple(const FGrappleSimParams& Params, FGrappleSimState State, float TimeStep, int32 NumSteps, TArray<FVector>& OutLocations);
+
 	//function to get whether or not we can grapple in the given direction
 	UFUNCTION(BlueprintCallable)
 	bool CanGrapple(bool DoSphereTrace);
@@ -5,6 +5,8 @@
 #include "CoreMinimal.h"
 #include "NiagaraComponent.h"
 #include "NiagaraSystem.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "Serialization/BitWriter.h"
 #include "RopeComponent.generated.h"
 
 //struct for rope points
@@ -40,6 +42,10 @@ struct FRopePoint
 	//whether or not to use world space for the location of the rope point
 	UPROPERTY(BlueprintReadOnly)
 	bool bUseWorldSpace = false;
+
+	//whether or not the world space location is fixed (a replicated pivot that isn't attached to an actor, not moved by the verlet simulation)
+	UPROPERTY(BlueprintReadOnly)
+	bool bIsPinned = false;
 	
 	////older locations of the rope point for verlet integration
 	//UPROPERTY(BlueprintReadOnly)
@@ -64,6 +70,9 @@ struct FRopePoint
 
 	//function to set the location of the rope point in world space (if using relative location, will set the location of the attached actor)
 	void SetWL(const FVector& NewLocation);
+
+	//function to check if the rope point is moved by the verlet simulation (everything else is a pivot)
+	bool IsSimulated() const { return bUseWorldSpace && !bIsPinned; }
 };
 
 //struct for constraints between rope points
@@ -113,6 +122,240 @@ struct FVerletConstraint
 	void SetDistance(float NewDistance);
 };
 
+//struct for a compact snapshot of the rope's state (stored as packed arrays so it can be saved and restored without reallocating)
+USTRUCT(BlueprintType)
+struct FRopeSnapshot
+{
+	GENERATED_BODY()
+
+	//the current version of the snapshot layout (bump this when the layout changes)
+	static constexpr uint8 CurrentVersion = 1;
+
+	//flags stored per rope point
+	enum EPointFlags : uint8
+	{
+		CollisionPoint = 1 << 0,
+		WorldSpace = 1 << 1,
+		Pinned = 1 << 2,
+	};
+
+	//the version of the layout this snapshot was saved with (0 = never saved)
+	UPROPERTY(BlueprintReadOnly)
+	uint8 Version = 0;
+
+	//whether or not the rope was active
+	UPROPERTY(BlueprintReadOnly)
+	bool bIsRopeActive = false;
+
+	//the grappleable component at the end of the rope
+	UPROPERTY()
+	class UGrappleableComponent* GrappleableComponent = nullptr;
+
+	//the locations of the rope points (relative or world space depending on the point's flags)
+	UPROPERTY()
+	TArray<FVector> Locations;
+
+	//the velocities of the rope points
+	UPROPERTY()
+	TArray<FVector> Velocities;
+
+	//the accelerations of the rope points
+	UPROPERTY()
+	TArray<FVector> Accelerations;
+
+	//the attached actors of the rope points
+	UPROPERTY()
+	TArray<AActor*> AttachedActors;
+
+	//the components of the rope points
+	UPROPERTY()
+	TArray<USceneComponent*> Components;
+
+	//the flags of the rope points (see EPointFlags)
+	UPROPERTY()
+	TArray<uint8> PointFlags;
+
+	//the rope point indices of the start points of the constraints
+	UPROPERTY()
+	TArray<int32> ConstraintStartIndices;
+
+	//the rope point indices of the end points of the constraints
+	UPROPERTY()
+	TArray<int32> ConstraintEndIndices;
+
+	//the compensation1 values of the constraints
+	UPROPERTY()
+	TArray<float> ConstraintCompensations1;
+
+	//the compensation2 values of the constraints
+	UPROPERTY()
+	TArray<float> ConstraintCompensations2;
+
+	//the distances of the constraints
+	UPROPERTY()
+	TArray<float> ConstraintDistances;
+
+	//function to check if this snapshot can be restored
+	bool IsValid() const { return Version == CurrentVersion; }
+
+	//function to get the number of rope points in this snapshot
+	int32 NumPoints() const { return Locations.Num(); }
+
+	//function to check if the point arrays and the constraint arrays all have the same lengths (snapshots made in blueprint might not)
+	bool HasMatchingLengths() const
+	{
+		const int32 NumConstraints = ConstraintStartIndices.Num();
+		return Velocities.Num() == NumPoints() && Accelerations.Num() == NumPoints() && AttachedActors.Num() == NumPoints() && Components.Num() == NumPoints() && PointFlags.Num() == NumPoints()
+			&& ConstraintEndIndices.Num() == NumConstraints && ConstraintCompensations1.Num() == NumConstraints && ConstraintCompensations2.Num() == NumConstraints && ConstraintDistances.Num() == NumConstraints;
+	}
+};
+
+//ring buffer of rope snapshots (slots are reused so capturing every frame doesn't allocate once the buffer is warm)
+USTRUCT(BlueprintType)
+struct FRopeSnapshotHistory
+{
+	GENERATED_BODY()
+
+	//the snapshot slots
+	UPROPERTY()
+	TArray<FRopeSnapshot> Snapshots;
+
+	//the index of the next slot to write to
+	int32 Head = 0;
+
+	//the number of valid snapshots in the buffer
+	int32 Count = 0;
+
+	//function to set the number of snapshots to keep (clears the buffer)
+	void SetCapacity(int32 NewCapacity);
+
+	//function to clear the buffer without freeing the slots
+	void Reset();
+
+	//function to get the next slot to write a snapshot into (overwrites the oldest snapshot when full)
+	FRopeSnapshot& Push();
+
+	//function to get a snapshot by how many pushes ago it was written (0 = newest), returns nullptr if there is none
+	const FRopeSnapshot* GetFromNewest(int32 Offset) const;
+
+	//function to get the number of snapshots the buffer can hold
+	int32 GetCapacity() const { return Snapshots.Num(); }
+};
+
+//struct for a replicated rope pivot (a rope point that isn't simulated by verlet integration), quantised so it's cheap to send
+USTRUCT()
+struct FRopeNetPivot : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	//flags stored per replicated pivot (OwnerRelative is only used by the rewind pivots, see FPlayerRewindPivot)
+	enum EPivotFlags : uint8
+	{
+		CollisionPoint = 1 << 0,
+		OwnerRelative = 1 << 1,
+		OwnerMesh = 1 << 2,
+		WorldLocation = 1 << 3,
+	};
+
+	//the index of the pivot along the rope (fast array items aren't kept in order on clients)
+	UPROPERTY()
+	uint8 PivotIndex = 0;
+
+	//the flags of the pivot (see EPivotFlags)
+	UPROPERTY()
+	uint8 Flags = 0;
+
+	//the actor the pivot is attached to (not sent when WorldLocation is set)
+	UPROPERTY()
+	AActor* AttachedActor = nullptr;
+
+	//the location of the pivot relative to the attached actor, or the world location when WorldLocation is set (the actor can't be referenced over the network)
+	UPROPERTY()
+	FVector Location = FVector::ZeroVector;
+
+	//function to serialize the pivot for replication
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
+	//fast array callbacks (mark the rope state as needing a rebuild on the client)
+	void PostReplicatedAdd(const struct FRopeNetState& InArraySerializer);
+	void PostReplicatedChange(const struct FRopeNetState& InArraySerializer);
+	void PreReplicatedRemove(const struct FRopeNetState& InArraySerializer);
+};
+
+template<>
+struct TStructOpsTypeTraits<FRopeNetPivot> : public TStructOpsTypeTraitsBase2<FRopeNetPivot>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+//struct for the replicated rope state (delta serialized so only pivots that changed since the last acknowledged state are sent)
+USTRUCT()
+struct FRopeNetState : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	//the replicated pivots of the rope
+	UPROPERTY()
+	TArray<FRopeNetPivot> Pivots;
+
+	//whether or not the client received pivots that haven't been applied to the rope yet
+	mutable bool bPivotsDirty = false;
+
+	//the number of bits the server has written for the pivots (to all connections) since the bandwidth was last logged
+	int64 NumBitsSent = 0;
+
+	//function to delta serialize the pivots
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		//get the size of the writer before the pivots are written (there's no writer when reading)
+		const int64 StartBits = DeltaParms.Writer ? DeltaParms.Writer->GetNumBits() : 0;
+
+		//delta serialize the pivots
+		const bool bResult = FFastArraySerializer::FastArrayDeltaSerialize<FRopeNetPivot, FRopeNetState>(Pivots, DeltaParms, *this);
+
+		//count the bits written for the pivots
+		NumBitsSent += DeltaParms.Writer ? DeltaParms.Writer->GetNumBits() - StartBits : 0;
+
+		return bResult;
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FRopeNetState> : public TStructOpsTypeTraitsBase2<FRopeNetState>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+//tick function for uploading the rope's render state after the simulation and the rest of the frame's movement are done
+USTRUCT()
+struct FRopeRenderTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	//the rope component to render
+	class URopeComponent* Target = nullptr;
+
+	//overrides
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+	virtual FName DiagnosticContext(bool bDetailed) override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FRopeRenderTickFunction> : public TStructOpsTypeTraitsBase2<FRopeRenderTickFunction>
+{
+	enum
+	{
+		WithCopy = false,
+	};
+};
+
 UCLASS()
 class URopeComponent : public USceneComponent
 {
@@ -120,8 +363,8 @@ class URopeComponent : public USceneComponent
 	
 public:
 
-	//list of classes that the rope should ignore when checking for collisions
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rope")
+	//list of classes that the rope should ignore when checking for collisions (blueprints set it through SetIgnoredClasses so the ignored actors are rebuilt)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, BlueprintSetter = SetIgnoredClasses, Category = "Rope")
 	TArray<TSubclassOf<AActor>> IgnoredClasses;
 
 	//the possible grappleable component for the end of the rope
@@ -215,6 +458,20 @@ public:
 	//array of collision points for the rope
 	TArray<FRopePoint*> CollisionPoints;
 
+	//how many frames of rope snapshots to keep in the snapshot history (0 = don't record history)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rope|Snapshots", meta = (ClampMin = 0))
+	int32 SnapshotHistoryLength = 0;
+
+	//the recorded rope snapshots (recorded at the end of every tick when SnapshotHistoryLength is above 0)
+	UPROPERTY(BlueprintReadOnly, Category = "Rope|Snapshots")
+	FRopeSnapshotHistory SnapshotHistory;
+
+	//the tick function that renders the rope in TG_PostUpdateWork (the primary tick simulates the rope after the owner's movement)
+	FRopeRenderTickFunction RenderTickFunction;
+
+	//whether or not the rope is stepped by the fixed-step simulation (keeps rendering while its own tick is disabled, see UHiltSimulationSubsystem)
+	bool bSteppedBySimulation = false;
+
 private:
 	//whether or not the rope is currently active
 	UPROPERTY(BlueprintReadOnly, Category = "Rope", meta=(AllowPrivateAccess))
@@ -224,6 +481,73 @@ private:
 	UPROPERTY(BlueprintReadOnly, Category = "Rope", meta = (AllowPrivateAccess))
 	class APlayerCharacter* PlayerCharacter = nullptr;
 
+	//the cached collision query params used by every rope and grapple trace (rebuilt only when the ignored actors change)
+	FCollisionQueryParams CachedCollisionParams;
+
+	//the actors of the ignored classes that currently exist in the world
+	UPROPERTY(Transient)
+	TSet<TObjectPtr<AActor>> IgnoredActors;
+
+	//handle for the world's actor spawned event
+	FDelegateHandle ActorSpawnedHandle;
+
+	//the grapple target subsystem of the world (caches the grappleable component of every hit component)
+	UPROPERTY(Transient)
+	TObjectPtr<class UGrappleTargetSubsystem> GrappleTargetSubsystem = nullptr;
+
+	//function to get the grappleable component of a hit without iterating the components of the hit actor
+	UGrappleableComponent* FindGrappleable(const FHitResult& Hit) const;
+
+	//function to check if an actor is of one of the ignored classes
+	bool IsIgnoredClass(const AActor* Actor) const;
+
+	//function to find all the actors of the ignored classes in the world and rebuild the cached collision query params
+	void RebuildIgnoredActors();
+
+	//function to rebuild the cached collision query params from the ignored actors
+	void RebuildCollisionParams();
+
+	//function called when an actor is spawned in the world
+	void OnActorSpawned(AActor* SpawnedActor);
+
+	//function called when an ignored actor is destroyed
+	UFUNCTION()
+	void OnIgnoredActorDestroyed(AActor* DestroyedActor);
+
+	//the replicated pivots of the rope (clients rebuild the verlet points between them locally)
+	UPROPERTY(Replicated)
+	FRopeNetState NetState;
+
+	//function to check if we're the server of a networked game and should update the replicated rope state
+	bool ShouldReplicateNetState() const;
+
+	//function to check if the rope is driven by the replicated rope state (only for simulated proxies, the locally controlled pawn predicts its own rope)
+	bool ShouldUseNetState() const;
+
+	//the gameplay time the replicated rope bandwidth was last logged at (see Hilt.Rope.LogNetBandwidth)
+	double LastNetBandwidthLogTime = 0;
+
+	//function to log the bandwidth used by the replicated pivots (once a second)
+	void LogNetBandwidth();
+
+	//function to update the replicated pivots from the current rope points (only marks pivots that changed as dirty)
+	void UpdateNetState();
+
+	//function to rebuild the rope from the replicated pivots on a client
+	void ApplyNetState();
+
+	//function to pack a rope point into a replicated pivot
+	void PackNetPivot(const FRopePoint& RopePoint, FRopeNetPivot& OutPivot) const;
+
+	//function to unpack a replicated pivot into a rope point
+	void UnpackNetPivot(const FRopeNetPivot& Pivot, FRopePoint& OutRopePoint) const;
+
+	//function to add the verlet points and constraints between the first and last rope points
+	void AddVerletPoints();
+
+	//function to destroy the niagara components past the given number of rope segments
+	void TrimNiagaraComponents(int32 NumSegments);
+
 public:
 
 	//constructor
@@ -231,8 +555,17 @@ public:
 
 	//overrides
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 	virtual void DestroyComponent(bool bPromoteChildren) override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void RegisterComponentTickFunctions(bool bRegister) override;
+
+	//function called by the render tick function to upload the rope's render state
+	void TickRender(float DeltaTime);
 
 	//function to enforce the constraints of the rope
 	void EnforceConstraints();
@@ -252,8 +585,12 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Rope")
 	void SetNiagaraSystem(UNiagaraSystem* NewSystem);
 
-	//function to get the collision query params used for the rope's collision checks
-	FCollisionQueryParams GetCollisionParams() const;
+	//function to get the collision query params used for the rope's collision checks (cached, ignores the owner and the actors of the ignored classes)
+	const FCollisionQueryParams& GetCollisionParams() const;
+
+	//function to set the classes the rope should ignore when checking for collisions (rebuilds the cached collision query params)
+	UFUNCTION(BlueprintCallable, Category = "Rope")
+	void SetIgnoredClasses(const TArray<TSubclassOf<AActor>>& NewIgnoredClasses);
 
 	//traces along the collision points and removes unnecessary collision points
 	void CheckCollisionPoints();
@@ -272,6 +609,27 @@ public:
 	UFUNCTION()
 	void ActivateRope(const FHitResult& HitResult);
 
+	//function to save the exact state of the rope into a snapshot (reuses the snapshot's arrays)
+	UFUNCTION(BlueprintCallable, Category = "Rope|Snapshots")
+	void SaveSnapshot(FRopeSnapshot& OutSnapshot) const;
+
+	//function to restore the exact state of the rope from a snapshot, returns false if the snapshot can't be restored
+	UFUNCTION(BlueprintCallable, Category = "Rope|Snapshots")
+	bool RestoreSnapshot(const FRopeSnapshot& Snapshot);
+
+	//function to restore the rope from the snapshot history (0 = the snapshot recorded last tick), returns false if there is no such snapshot
+	UFUNCTION(BlueprintCallable, Category = "Rope|Snapshots")
+	bool RestoreSnapshotFromHistory(int32 FramesAgo);
+
+	//function to get the number of pivots (the rope points that aren't simulated verlet points) the rope saves into a rewind frame
+	int32 GetNumRewindPivots() const;
+
+	//function to save the pivots of the rope into a rewind frame (quantised, relative to their attached actor or the owner)
+	void SaveRewindPivots(struct FPlayerRewindPivot* OutPivots, int32 NumPivots) const;
+
+	//function to rebuild the rope from the pivots of a rewind frame (the verlet points between the ends are added again), the owner has to be restored first
+	void RestoreRewindPivots(const struct FPlayerRewindPivot* Pivots, int32 NumPivots);
+
 	/**
 	 * Getters
 	*/
@@ -0,0 +1,119 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "GroundProbeComponent.generated.h"
+
+class UPhysicalMaterial;
+
+//struct for the result of a ground probe
+USTRUCT(BlueprintType)
+struct FGroundProbeResult
+{
+	GENERATED_BODY()
+
+	//whether or not there was ground within the probe distance
+	UPROPERTY(BlueprintReadOnly)
+	bool bHasGround = false;
+
+	//whether or not the probe started inside geometry
+	UPROPERTY(BlueprintReadOnly)
+	bool bStartPenetrating = false;
+
+	//the location the probe was traced from
+	UPROPERTY(BlueprintReadOnly)
+	FVector ProbeStart = FVector::ZeroVector;
+
+	//the distance from the probe start to the ground (the probe distance if there was no ground)
+	UPROPERTY(BlueprintReadOnly)
+	float Distance = 0;
+
+	//the location and normal of the ground
+	UPROPERTY(BlueprintReadOnly)
+	FVector Location = FVector::ZeroVector;
+	UPROPERTY(BlueprintReadOnly)
+	FVector Normal = FVector::UpVector;
+
+	//the physical material of the ground
+	UPROPERTY(BlueprintReadOnly)
+	TObjectPtr<UPhysicalMaterial> PhysicalMaterial = nullptr;
+
+	//the frame the probe was traced on
+	uint64 Frame = 0;
+};
+
+/**
+ * Probes the ground below the owner once per frame with an async line trace and publishes the distance, normal and physical material for every system that needs it (movement, camera, slide, landing prediction).
+ * The result is from the previous frame's location, consumers that need same-frame certainty can use the synchronous fallback.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class HILT_API UGroundProbeComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	//whether or not to probe the ground every frame
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ground Probe")
+	bool bProbeEveryFrame = true;
+
+	//how far below the owner to probe for ground (should cover the longest distance any consumer asks for)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ground Probe")
+	float ProbeDistance = 1000;
+
+	//the collision channel to probe on
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ground Probe")
+	TEnumAsByte<ECollisionChannel> CollisionChannel = ECC_Visibility;
+
+	//the max number of frames old the async result can be before the synchronous fallback is used instead
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ground Probe")
+	int32 MaxResultAge = 1;
+
+	//constructor
+	UGroundProbeComponent();
+
+	//overrides
+	virtual void BeginPlay() override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	//function to get the last async ground probe result
+	const FGroundProbeResult& GetGroundResult() const { return GroundResult; }
+
+	//function to get a copy of the last async ground probe result
+	UFUNCTION(BlueprintCallable, Category = "Ground Probe", DisplayName = "Get Ground Result")
+	FGroundProbeResult K2_GetGroundResult() const { return GroundResult; }
+
+	//function to get whether or not the last async result is recent enough to use
+	UFUNCTION(BlueprintCallable, Category = "Ground Probe")
+	bool IsResultFresh() const;
+
+	//function to get whether or not there's ground within a distance below the owner (uses the async result if it's fresh and covers the distance, otherwise probes synchronously)
+	UFUNCTION(BlueprintCallable, Category = "Ground Probe")
+	bool HasGroundWithin(float Distance, bool bRequireSameFrame = false);
+
+	//function to probe the ground synchronously (for when a consumer needs a same-frame result)
+	UFUNCTION(BlueprintCallable, Category = "Ground Probe")
+	FGroundProbeResult ProbeGroundSync(float Distance) const;
+
+private:
+
+	//the last async ground probe result
+	FGroundProbeResult GroundResult;
+
+	//the query params for the probe
+	FCollisionQueryParams QueryParams;
+
+	//the delegate for the async probe
+	FTraceDelegate ProbeTraceDelegate;
+
+	//function called when the async probe is done
+	void OnProbeTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	//function to get the start and end of a probe
+	void GetProbeStartEnd(float Distance, FVector& OutStart, FVector& OutEnd) const;
+
+	//function to fill a probe result from a hit
+	static void FillResult(const FHitResult& Hit, const FVector& Start, float Distance, FGroundProbeResult& OutResult);
+};
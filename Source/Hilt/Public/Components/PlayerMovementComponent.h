@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "CollisionQueryParams.h"
+#include "Core/HiltTimerSubsystem.h"
+#include "Core/MovementTelemetry.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "PhysicalMaterials/PhysicalMaterial.h"
 #include "PlayerMovementComponent.generated.h"
@@ -12,6 +14,84 @@ class APlayerCharacter;
 class UPlayerCameraComponent;
 class AGrapplingHookHead;
 
+//the player's custom movement modes (MOVE_Custom sub modes, the movement mode is sent with every saved move so these are predicted and corrected like the default modes)
+enum EPlayerCustomMovementMode : uint8
+{
+	CMOVE_None = 0,
+
+	//sliding on the ground (counts as moving on the ground)
+	CMOVE_Slide,
+
+	//diving in the air (counts as falling)
+	CMOVE_Dive,
+};
+
+//the slide parameters of the current frame (computed once per frame in PhysSlide instead of in every substep)
+struct FSlideModeParams
+{
+	//the ground friction to slide with
+	float GroundFriction = 0;
+};
+
+//the dive parameters of the current frame (computed once per frame in PhysDive instead of in every substep)
+struct FDiveModeParams
+{
+	//the multipliers of the terminal velocity, air control and max wasd speed from the dive curves
+	float TerminalVelocityMultiplier = 1;
+	float AirControlMultiplier = 1;
+	float MaxSpeedMultiplier = 1;
+};
+
+//saved move for the player's custom movement state, so slide, dive and slide jump are predicted and replayed like the default movement
+class FSavedMove_Player : public FSavedMove_Character
+{
+public:
+
+	//the compressed flags for the player's custom input and state
+	enum ECustomFlags
+	{
+		//the slide button is held (slides on the ground, dives in the air)
+		FLAG_WantsToSlide = FLAG_Custom_0,
+
+		//the player is slide jumping
+		FLAG_SlideJumping = FLAG_Custom_1,
+	};
+
+	//the slide input of the move
+	uint8 bSavedWantsToSlide : 1;
+
+	//the slide, dive and slide jump state at the start of the move
+	uint8 bSavedIsSliding : 1;
+	uint8 bSavedIsDiving : 1;
+	uint8 bSavedIsSlideJumping : 1;
+	float SavedCurrentSlideSpeed = 0;
+	float SavedSlideJumpTimeRemaining = 0;
+	float SavedGravityScale = 1;
+
+	//the buffered jump and slide presses at the start of the move
+	float SavedBufferedJumpTimeRemaining = 0;
+	float SavedBufferedSlideTimeRemaining = 0;
+
+	//overrides
+	virtual void Clear() override;
+	virtual uint8 GetCompressedFlags() const override;
+	virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+	virtual void SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData) override;
+	virtual void PrepMoveFor(ACharacter* C) override;
+};
+
+//client prediction data that allocates the player's saved moves
+class FNetworkPredictionData_Client_Player : public FNetworkPredictionData_Client_Character
+{
+public:
+
+	//constructor
+	explicit FNetworkPredictionData_Client_Player(const UCharacterMovementComponent& ClientMovement);
+
+	//overrides
+	virtual FSavedMovePtr AllocateNewMove() override;
+};
+
 /**
  * Movement component for the player character that extends the default character movement component
  */
@@ -133,6 +213,10 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement")
 	float SpeedLimit = 4000;
 
+	//the speed limit modifier of the current score tier (cached when the score tier changes)
+	UPROPERTY(BlueprintReadOnly, Category = "Movement")
+	float ScoreSpeedLimitModifier = 1;
+
 	//whether or not the player is currently forced to be under the speed limit
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Movement")
 	bool bIsSpeedLimited = true;
@@ -157,6 +241,26 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Character Movement: Jumping / Falling")
 	float AvoidBunnyJumpTraceDistance = 1000;
 
+	//whether or not the bunny jump check should always probe the ground synchronously instead of using the ground probe's result from last frame
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Character Movement: Jumping / Falling")
+	bool bSyncBunnyJumpProbe = false;
+
+	//whether or not to split fast movement into substeps when there's geometry in the way (so high speed collisions don't depend on the frame rate)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement|Substepping")
+	bool bUseAdaptiveSubstepping = true;
+
+	//the max distance the player can move in one substep before the frame is split into more substeps
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement|Substepping", meta = (ClampMin = "1"))
+	float MaxSubstepDistance = 50;
+
+	//the max number of substeps per frame
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement|Substepping", meta = (ClampMin = "1"))
+	int32 MaxSubstepsPerFrame = 8;
+
+	//how long a jump or slide pressed in the air is buffered for, so a press just before landing is still applied on the substep the player lands on (0 = no buffering)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement|Input Buffer", meta = (ClampMin = "0"))
+	float InputBufferWindow = 0.15f;
+
 	//whether or not the player is currently sliding
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Movement|Sliding")
 	bool bIsSliding = false;
@@ -216,12 +320,35 @@ public:
 	//whether or not we're slide jumping
 	bool bIsSlideJumping = false;
 
+	//the time left before the slide jump ends and gravity is restored (counted down in movement time so it's replayed with the moves)
+	float SlideJumpTimeRemaining = 0;
+
+	//whether or not the slide button is held (sent to the server in the compressed flags, slides on the ground and dives in the air)
+	bool bWantsToSlide = false;
+
+	//the time left on the buffered jump and slide presses (counted down in movement time, so the server buffers the same presses from the replicated input)
+	float BufferedJumpTimeRemaining = 0;
+	float BufferedSlideTimeRemaining = 0;
+
 	//timer handle for banking slide score
-	FTimerHandle SlideScoreBankTimer;
+	FHiltTimerHandle SlideScoreBankTimer;
 
 	//the gravity scale used at begin play
 	float DefaultGravityScale = 1;
 
+	//the max simulation iterations used at begin play
+	int32 DefaultMaxSimulationIterations = 8;
+
+	//the substep time of the current frame (0 = not substepping)
+	float AdaptiveSubstepTime = 0;
+
+	//the parameters of the slide and dive movement modes for the current frame
+	FSlideModeParams SlideParams;
+	FDiveModeParams DiveParams;
+
+	//the movement telemetry writer (only created when telemetry is enabled)
+	TUniquePtr<FMovementTelemetryWriter> TelemetryWriter;
+
 	//the time when the slide fall started
 	float SlideFallStartTime = 0;
 
@@ -270,6 +397,10 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Movement")
 	float GetCurrentSpeedLimit() const;
 
+	//function called when the player's score tier changes to cache the score values we read every tick
+	UFUNCTION()
+	void OnScoreTierChanged(int32 NewTier, int32 OldTier);
+
 	//function to start sliding
 	UFUNCTION(BlueprintCallable, Category = "Movement")
 	void StartSlide();
@@ -286,6 +417,9 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Movement")
 	void BankSlideScore();
 
+	//function to restore the slide state after a rewind (starts or stops the slide score banking to match, without the slide events or banking the pending score)
+	void RestoreSlideState(bool bSliding, float InPendingSlideScore, float InSlideSpeedGained);
+
 	//function to get the direction the player is currently sliding
 	UFUNCTION(BlueprintCallable, Category = "Movement")
 	FVector GetSlideSurfaceDirection();
@@ -304,9 +438,13 @@ public:
 
 	//override functions
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
-	virtual void PhysWalking(float deltaTime, int32 Iterations) override;
 	virtual void PhysFalling(float deltaTime, int32 Iterations) override;
+	virtual void PhysCustom(float deltaTime, int32 Iterations) override;
+	virtual bool IsMovingOnGround() const override;
+	virtual bool IsFalling() const override;
+	virtual void OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode) override;
 	virtual bool IsWalkable(const FHitResult& Hit) const override;
 	virtual void PerformMovement(float DeltaTime) override;
 	virtual void HandleWalkingOffLedge(const FVector& PreviousFloorImpactNormal, const FVector& PreviousFloorContactNormal, const FVector& PreviousLocation, float TimeDelta) override;
@@ -327,5 +465,34 @@ public:
 	virtual void HandleImpact(const FHitResult& Hit, float TimeSlice, const FVector& MoveDelta) override;
 	virtual void ApplyImpactPhysicsForces(const FHitResult& Impact, const FVector& ImpactAcceleration, const FVector& ImpactVelocity) override;
 	virtual void ProcessLanded(const FHitResult& Hit, float remainingTime, int32 Iterations) override;
+	virtual void SetPostLandedPhysics(const FHitResult& Hit) override;
 	virtual bool DoJump(bool bReplayingMoves) override;
+	virtual void UpdateFromCompressedFlags(uint8 Flags) override;
+	virtual void UpdateCharacterStateBeforeMovement(float DeltaSeconds) override;
+	virtual FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+	virtual float GetSimulationTimeStep(float RemainingTime, int32 Iterations) const override;
+
+	//function to get whether or not we're in one of our custom movement modes
+	bool IsCustomMovementMode(EPlayerCustomMovementMode InCustomMovementMode) const;
+
+	//function to simulate the slide movement mode (the slide speed and score, then the walking floor following with the slide parameters)
+	void PhysSlide(float deltaTime, int32 Iterations);
+
+	//function to simulate the dive movement mode (the falling integration with the dive parameters, landing ends the dive)
+	void PhysDive(float deltaTime, int32 Iterations);
+
+	//function to record this frame's movement telemetry
+	void RecordTelemetry() const;
+
+	//function to buffer the jump and slide presses made in the air and count down the buffered presses
+	void UpdateInputBuffer(float DeltaSeconds);
+
+	//function to update the substep time of the frame from the speed of the player and a sweep along its movement
+	void UpdateAdaptiveSubstepTime(float DeltaTime);
+
+	//function to get whether or not the client is replaying its saved moves after a server correction (events and score shouldn't be triggered again)
+	bool IsReplayingMoves() const;
+
+	//function to end the slide jump and restore gravity
+	void EndSlideJump();
 };
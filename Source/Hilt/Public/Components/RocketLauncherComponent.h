@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Core/HiltTimerSubsystem.h"
 #include "Helpers/ProjectileGunComponent.h"
 #include "RocketLauncherComponent.generated.h"
 
@@ -47,7 +48,7 @@ public:
 	UPROPERTY(BlueprintReadOnly, Category = "Rocket Launcher")
 	float LastReloadTime = 0.f;
 
-	//whether reloading is enabled
+	//whether reloading is enabled (use SetReloadingEnabled to change it at runtime)
 	UPROPERTY(EditAnywhere, Category = "Rocket Launcher")
 	bool bEnableReloading = false;
 
@@ -58,8 +59,10 @@ public:
 	//override(s)
 	virtual AActor* FireProjectile(FVector Direction) override;
 	virtual void OnProjectileHit(AActor* Projectile, AActor* OtherActor, FVector NormalImpulse, const FHitResult& Hit) override;
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 	virtual void BeginPlay() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
 
 	//function(s)
 
@@ -70,4 +73,19 @@ public:
 	//function to reset the rocket launcher
 	UFUNCTION(BlueprintCallable, Category = "Rocket Launcher")
 	void ResetRocketLauncher();
+
+	//function to enable or disable reloading (starts or stops the reload timer)
+	UFUNCTION(BlueprintCallable, Category = "Rocket Launcher")
+	void SetReloadingEnabled(bool bEnabled);
+
+private:
+
+	//timer handle for loading the next rocket into the clip
+	FHiltTimerHandle ReloadTimerHandle;
+
+	//function to start the reload timer if reloading is enabled, the clip isn't full and it isn't already running
+	void StartReloadTimer();
+
+	//function called by the reload timer to load a rocket into the clip if reloading is still enabled
+	void OnReloadTimer();
 };
@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "Core/HiltTimerSubsystem.h"
 #include "Helpers/ProjectileGunComponent.h"
 #include "TerrainGunComponent.generated.h"
 
@@ -30,7 +31,7 @@ class UTerrainGunComponent : public UProjectileGunComponent
 	float ProjectileLifeTime = 5.0f;
 
 	//timer handle to turn the projectile into terrain
-	FTimerHandle TerrainTimerHandle;
+	FHiltTimerHandle TerrainTimerHandle;
 
 	//delegate to handle when the terrain is spawned
 	UPROPERTY(BlueprintAssignable)
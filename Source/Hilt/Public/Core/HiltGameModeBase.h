@@ -3,6 +3,7 @@
 // Includes
 #include "CoreMinimal.h"
 #include "GameFramework/GameModeBase.h"
+#include "Core/HiltTimerSubsystem.h"
 #include "HiltGameModeBase.generated.h"
 
 // Forward Declaration`s
@@ -38,7 +39,7 @@ public:
 	UPROPERTY(BlueprintReadWrite, VisibleAnywhere, Category = "Variables-Time")
 	float RestartCooldown = 0.3f;
 	bool canRestart = true;
-	FTimerHandle RestartCooldownHandler;
+	FHiltTimerHandle RestartCooldownHandler;
 
 	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category = "Variables-Game")
 	int TotalNumActiveObjectives = 0;
@@ -0,0 +1,41 @@
+#pragma once
+#include "CoreMinimal.h"
+
+//whether or not the gameplay profiling counters are compiled in
+#ifndef HILT_PROFILING
+#define HILT_PROFILING !UE_BUILD_SHIPPING
+#endif
+
+//counters used by the benchmark commandlets to measure the cost of gameplay code (only touched on the game thread)
+namespace HiltProfiling
+{
+	//the number of scene queries (traces and sweeps) issued since the counters were last reset
+	extern HILT_API int32 SceneQueries;
+
+	//the number of heap allocations (and reallocations) made on the game thread while an allocation counter is installed, since the counters were last reset
+	extern HILT_API int32 Allocations;
+
+	//function to reset all the counters
+	HILT_API void ResetCounters();
+
+	//scoped wrapper around the global allocator that counts the game thread's allocations in Allocations (for benchmarks, every allocation goes through an extra call while it's installed)
+	class HILT_API FScopedAllocationCounter
+	{
+	public:
+
+		FScopedAllocationCounter();
+		~FScopedAllocationCounter();
+
+	private:
+
+		//the allocator that was installed before us
+		FMalloc* PreviousMalloc = nullptr;
+	};
+}
+
+//macro for counting a scene query
+#if HILT_PROFILING
+#define HILT_COUNT_SCENE_QUERY() (++HiltProfiling::SceneQueries)
+#else
+#define HILT_COUNT_SCENE_QUERY()
+#endif
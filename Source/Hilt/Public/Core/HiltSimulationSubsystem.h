@@ -0,0 +1,174 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HiltSimulationSubsystem.generated.h"
+
+class APlayerCharacter;
+
+//the buttons of a recorded input frame (held buttons are set every step they're held, pressed buttons only on the step they were pressed)
+enum EHiltInputButtons : uint8
+{
+	HiltInput_Jump = 1 << 0,
+	HiltInput_Slide = 1 << 1,
+	HiltInput_Grapple = 1 << 2,
+	HiltInput_StopGrapple = 1 << 3,
+	HiltInput_Fire = 1 << 4,
+};
+
+//the player input of one fixed step (written to and read from the recording files as is)
+struct FHiltInputFrame
+{
+	//the world space movement input added to the player
+	FVector3f MovementInput = FVector3f::ZeroVector;
+
+	//the wasd direction of the player
+	FVector2f MoveDirection = FVector2f::ZeroVector;
+
+	//the control rotation of the player
+	FRotator3f ControlRotation = FRotator3f::ZeroRotator;
+
+	//the buttons of the step (EHiltInputButtons)
+	uint8 Buttons = 0;
+	uint8 Padding[3] = {};
+
+	//the location of the player after the step (used to check how far a replay drifted from the recording)
+	FVector3f ResultLocation = FVector3f::ZeroVector;
+};
+
+//the header at the start of a recording file (followed by NumFrames input frames)
+struct FHiltRecordingHeader
+{
+	uint32 Magic = 0;
+	uint32 Version = 0;
+
+	//the step rate the recording was made with
+	uint32 StepRate = 0;
+
+	//the number of input frames
+	uint32 NumFrames = 0;
+
+	//the location and rotation of the player at the first step
+	FVector3f StartLocation = FVector3f::ZeroVector;
+	FRotator3f StartRotation = FRotator3f::ZeroRotator;
+};
+
+/**
+ * World subsystem for the deterministic fixed-step simulation mode.
+ * When enabled (-HiltFixedStep=<rate>, Hilt.Sim.FixedStepRate or a replay) the player's movement, rope, grapple and score components stop ticking on their own and are stepped here with a fixed time step, from an input frame captured once per step.
+ * Gameplay time comes from the step counter (see GetGameplayTime), so the same input frames give the same trajectory.
+ * The input frames can be recorded (-HiltRecord=<file>) and replayed (-HiltReplay=<file>), -HiltReplayFast steps replays as fast as possible and -HiltReplayExit quits once the replay is done, e.g.
+ * UnrealEditor-Cmd Hilt.uproject /Game/Levels/Map_Pacer -game -nullrhi -unattended -HiltReplay=Run.hrec -HiltReplayFast -HiltReplayExit
+ */
+UCLASS()
+class HILT_API UHiltSimulationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	//the magic number and version of the recording files
+	static constexpr uint32 RecordingMagic = 0x43455248; // "HREC"
+	static constexpr uint32 RecordingVersion = 1;
+
+	//function to get the gameplay time of a world (the step time in fixed-step mode, otherwise the world time)
+	static double GetGameplayTime(const UObject* WorldContextObject);
+
+	//function to get whether or not the fixed-step mode is enabled
+	bool IsFixedStep() const { return FixedTimeStep > 0; }
+
+	//function to get the fixed time step
+	double GetFixedTimeStep() const { return FixedTimeStep; }
+
+	//function to get the number of steps simulated so far
+	uint64 GetStepCount() const { return StepCount; }
+
+	//function to get the time of the current step
+	double GetStepTime() const { return StepCount * FixedTimeStep; }
+
+	//function to get whether or not we're replaying a recording
+	bool IsReplaying() const { return bReplaying; }
+
+	//function to register the player to simulate
+	void RegisterPlayer(APlayerCharacter* Player);
+
+	//function to queue pressed buttons for the next step (returns false if the buttons should be handled right away because we're not in fixed-step mode)
+	bool QueueButtons(uint8 Buttons);
+
+	//function to write the recorded input frames to a file
+	bool SaveRecording(const FString& FilePath) const;
+
+	//function to read a recording file
+	static bool LoadRecordingFile(const FString& FilePath, FHiltRecordingHeader& OutHeader, TArray<FHiltInputFrame>& OutFrames);
+
+	//function to apply an input frame to the player (updates the camera for the new control rotation with the step time)
+	static void ApplyInputFrame(APlayerCharacter* Player, const FHiltInputFrame& Frame, float DeltaTime);
+
+	//function to update the player's camera arm and camera manager after the control rotation changed
+	static void UpdatePlayerView(APlayerCharacter* Player, float DeltaTime);
+
+	//function to stop the player's stepped components from ticking on their own
+	static void DisableComponentTicks(const APlayerCharacter* Player);
+
+	//overrides
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual bool IsTickable() const override;
+
+protected:
+
+	//overrides
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+
+	//the player being simulated
+	TWeakObjectPtr<APlayerCharacter> SimulatedPlayer;
+
+	//the fixed time step (0 = fixed-step mode disabled)
+	double FixedTimeStep = 0;
+
+	//the frame time that hasn't been simulated by a step yet
+	double TimeAccumulator = 0;
+
+	//the number of steps simulated so far
+	uint64 StepCount = 0;
+
+	//the max number of steps per frame (so a hitch doesn't spiral)
+	int32 MaxStepsPerFrame = 8;
+
+	//the buttons pressed since the last step
+	uint8 QueuedButtons = 0;
+
+	//the input frame captured from the player this frame
+	FHiltInputFrame LiveFrame;
+
+	//the recording settings
+	bool bRecording = false;
+	FString RecordingPath;
+	FHiltRecordingHeader RecordingHeader;
+	TArray<FHiltInputFrame> RecordedFrames;
+
+	//the replay settings and state
+	bool bReplaying = false;
+	bool bReplayFast = false;
+	bool bExitAfterReplay = false;
+	TArray<FHiltInputFrame> ReplayFrames;
+	FHiltRecordingHeader ReplayHeader;
+	int32 ReplayIndex = 0;
+	float MaxReplayDrift = 0;
+	double ReplayStartTime = 0;
+
+	//function to capture the live input of the player for this frame
+	void CaptureLiveFrame(APlayerCharacter* Player);
+
+	//function to simulate one step of the player
+	void StepPlayer(APlayerCharacter* Player);
+
+	//function called when the replay has run out of input frames
+	void FinishReplay();
+};
@@ -0,0 +1,148 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HiltTimerSubsystem.generated.h"
+
+//the flags of a gameplay timer
+enum EHiltTimerFlags : uint8
+{
+	HiltTimer_None = 0,
+
+	//the timer is cancelled when the level restarts (see UHiltTimerSubsystem::CancelTimers)
+	HiltTimer_CancelOnRestart = 1 << 0,
+};
+
+//handle to a gameplay timer (stored inline in the timer's owner, a handle whose timer fired or was cancelled is simply inactive)
+struct FHiltTimerHandle
+{
+	//function to get whether or not the handle has ever been set
+	bool IsValid() const { return Serial != 0; }
+
+	//function to reset the handle (doesn't cancel the timer, use UHiltTimerSubsystem::ClearTimer for that)
+	void Invalidate() { Index = INDEX_NONE; Serial = 0; }
+
+private:
+
+	friend class UHiltTimerSubsystem;
+
+	//the index of the timer in the timer pool
+	int32 Index = INDEX_NONE;
+
+	//the serial number of the timer (so a reused pool entry doesn't match an old handle)
+	uint32 Serial = 0;
+};
+
+/**
+ * World subsystem for gameplay timers, as a hashed timing wheel.
+ * Timers are hashed into a slot by their expiry tick, so setting and clearing a timer is O(1) and each frame only visits the slots the clock moved past.
+ * Expired timers are dispatched in one batch per frame, in expiry order.
+ * Timers run on gameplay time (see UHiltSimulationSubsystem::GetGameplayTime), so they pause with the game and follow the step clock in fixed-step mode.
+ */
+UCLASS()
+class HILT_API UHiltTimerSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	//the length of a wheel tick (in seconds) and the number of slots in the wheel (timers further out than one turn wait in their slot for the later turns)
+	static constexpr double TickLength = 1.0 / 120.0;
+	static constexpr int32 NumSlots = 256;
+
+	//function to get the timer subsystem of a world
+	static UHiltTimerSubsystem* Get(const UObject* WorldContextObject);
+
+	//function to set a timer (clears the handle's current timer first), looping timers fire once per interval
+	void SetTimer(FHiltTimerHandle& InOutHandle, const FTimerDelegate& Delegate, float Delay, bool bLoop = false, uint8 Flags = HiltTimer_None);
+
+	//function to set a timer that calls a member function
+	template <typename UserClass>
+	void SetTimer(FHiltTimerHandle& InOutHandle, UserClass* Object, void (UserClass::*Function)(), const float Delay, const bool bLoop = false, const uint8 Flags = HiltTimer_None)
+	{
+		SetTimer(InOutHandle, FTimerDelegate::CreateUObject(Object, Function), Delay, bLoop, Flags);
+	}
+
+	//function to clear a timer and invalidate its handle
+	void ClearTimer(FHiltTimerHandle& InOutHandle);
+
+	//function to get whether or not a handle's timer is still waiting to fire
+	bool IsTimerActive(const FHiltTimerHandle& Handle) const;
+
+	//function to get the time left before a handle's timer fires (-1 if it's not active)
+	float GetTimerRemaining(const FHiltTimerHandle& Handle) const;
+
+	//function to cancel every timer with any of the given flags
+	void CancelTimers(uint8 Flags);
+
+	//function to fire the timers that have expired by the current gameplay time (called every frame, and after every step in fixed-step mode)
+	void Dispatch();
+
+	//overrides
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+
+	//overrides
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+
+	//struct for a timer in the pool
+	struct FTimer
+	{
+		//the function to call
+		FTimerDelegate Delegate;
+
+		//the time the timer expires at and the wheel tick it's dispatched on
+		double ExpireTime = 0;
+		int64 ExpireTick = 0;
+
+		//the interval of a looping timer (0 = not looping)
+		float Interval = 0;
+
+		//the serial number of the timer (0 = free pool entry)
+		uint32 Serial = 0;
+
+		//the flags of the timer (EHiltTimerFlags)
+		uint8 Flags = HiltTimer_None;
+
+		//the previous and next timer in the same slot (the next free entry for free pool entries)
+		int32 Prev = INDEX_NONE;
+		int32 Next = INDEX_NONE;
+	};
+
+	//the timer pool
+	TArray<FTimer> Timers;
+
+	//the first free entry of the timer pool
+	int32 FirstFree = INDEX_NONE;
+
+	//the first timer of each slot
+	TArray<int32, TFixedAllocator<NumSlots>> SlotHeads;
+
+	//the last wheel tick that was dispatched
+	int64 CurrentTick = 0;
+
+	//the last serial number handed out
+	uint32 LastSerial = 0;
+
+	//the expired timers of the current dispatch (kept to avoid reallocating every frame)
+	TArray<TPair<int32, uint32>> ExpiredTimers;
+
+	//function to get the timer of a handle (nullptr if it's not active)
+	const FTimer* FindTimer(const FHiltTimerHandle& Handle) const;
+
+	//function to add a timer to the slot of its expiry tick
+	void LinkTimer(int32 Index);
+
+	//function to remove a timer from its slot
+	void UnlinkTimer(int32 Index);
+
+	//function to remove a timer from its slot and return it to the pool
+	void FreeTimer(int32 Index);
+};
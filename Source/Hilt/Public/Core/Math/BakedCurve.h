@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UCurveFloat;
+
+//a float curve sampled into a uniform lookup table (evaluates with one multiply and one lerp instead of a key search and a cubic)
+struct HILT_API FBakedCurveFloat
+{
+	//the curve the table was baked from
+	const UCurveFloat* Source = nullptr;
+
+	//the time of the first sample and the inverse of the time between samples
+	float MinTime = 0;
+	float InvStep = 0;
+
+	//the sampled values (at least 2)
+	TArray<float> Samples;
+
+	//the largest difference between the table and the source curve found when baking
+	float MaxError = 0;
+
+	//whether or not the curve extrapolates in a way the table can't (linear or cycling), in which case the source curve is evaluated instead
+	bool bPassThrough = false;
+
+	//function to bake the table from a curve
+	void Bake(const UCurveFloat* Curve);
+
+	//function to evaluate the table at a time (clamps to the ends of the curve like constant extrapolation)
+	float Evaluate(float Time) const;
+
+	//function to evaluate the table at many times at once (four at a time with vector math)
+	void EvaluateBatch(TArrayView<const float> Times, TArrayView<float> OutValues) const;
+};
+
+//functions for the baked float curves shared by all hot path curve evaluations (the bake and cache are game thread only, baked tables can be read from any thread)
+namespace HiltCurves
+{
+	//the number of entries in the evaluation cache (a power of 2)
+	static constexpr int32 CacheSize = 256;
+
+	//an entry of the direct mapped evaluation cache
+	struct FCacheEntry
+	{
+		const UCurveFloat* Curve = nullptr;
+		const FBakedCurveFloat* Baked = nullptr;
+		uint32 Generation = 0;
+	};
+
+	//the evaluation cache and the generation of the baked tables (bumped whenever a curve is rebaked or garbage is collected so the cache entries are refreshed)
+	extern HILT_API FCacheEntry Cache[CacheSize];
+	extern HILT_API uint32 Generation;
+
+	//function to get the baked table of a curve, baking it on first use
+	HILT_API const FBakedCurveFloat* FindOrBake(const UCurveFloat* Curve);
+
+	//function to bake every float curve referenced by the properties of an object (including arrays of structs like the score values)
+	HILT_API void BakeReferencedCurves(const UObject* Object);
+
+	//function to throw away every baked table so they're rebaked on next use
+	HILT_API void RebakeAll();
+
+	//function to print the size and max error of every baked table
+	HILT_API void ReportErrors();
+
+	//function to evaluate a curve through its baked table
+	FORCEINLINE float Evaluate(const UCurveFloat* Curve, const float Time)
+	{
+		//get the cache entry of the curve
+		const FCacheEntry& Entry = Cache[(UPTRINT(Curve) >> 4) & (CacheSize - 1)];
+
+		//use the cached table if it's for this curve and up to date
+		const FBakedCurveFloat* Baked = Entry.Curve == Curve && Entry.Generation == Generation ? Entry.Baked : FindOrBake(Curve);
+
+		return Baked->Evaluate(Time);
+	}
+}
@@ -0,0 +1,120 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include <atomic>
+
+class FRunnableThread;
+
+//the state flags of a movement telemetry record
+enum EMovementTelemetryFlags : uint8
+{
+	MovementTelemetry_Sliding = 1 << 0,
+	MovementTelemetry_Diving = 1 << 1,
+	MovementTelemetry_SlideJumping = 1 << 2,
+	MovementTelemetry_SlideFalling = 1 << 3,
+	MovementTelemetry_Grappling = 1 << 4,
+	MovementTelemetry_SpeedLimited = 1 << 5,
+};
+
+/**
+ * One frame of player movement telemetry (40 bytes, written to the telemetry files as is, little endian).
+ *
+ * File schema (.htel): FMovementTelemetryHeader followed by records until the end of the file.
+ *   offset  size  field
+ *   0       4     Frame          uint32, the engine frame counter
+ *   4       4     Time           float, gameplay time in seconds
+ *   8       12    Location       3 x float, world location of the player
+ *   20      12    Velocity       3 x float, velocity of the player
+ *   32      4     Score          float, the player's score
+ *   36      1     MovementMode   uint8, EMovementMode
+ *   37      1     Flags          uint8, EMovementTelemetryFlags
+ *   38      1     ScoreTier      uint8, the player's score tier
+ *   39      1     Padding
+ */
+struct FMovementTelemetryRecord
+{
+	uint32 Frame = 0;
+	float Time = 0;
+	FVector3f Location = FVector3f::ZeroVector;
+	FVector3f Velocity = FVector3f::ZeroVector;
+	float Score = 0;
+	uint8 MovementMode = 0;
+	uint8 Flags = 0;
+	uint8 ScoreTier = 0;
+	uint8 Padding = 0;
+};
+static_assert(sizeof(FMovementTelemetryRecord) == 40, "the telemetry record layout is part of the file schema");
+
+//the header at the start of a telemetry file
+struct FMovementTelemetryHeader
+{
+	//the magic number and version of the telemetry files
+	static constexpr uint32 FileMagic = 0x4C455448; // "HTEL"
+	static constexpr uint32 FileVersion = 1;
+
+	uint32 Magic = FileMagic;
+	uint32 Version = FileVersion;
+
+	//the size of a record (so readers can check they match the schema)
+	uint32 RecordSize = sizeof(FMovementTelemetryRecord);
+	uint32 Reserved = 0;
+};
+static_assert(sizeof(FMovementTelemetryHeader) == 16, "the telemetry header layout is part of the file schema");
+
+/**
+ * Records player movement telemetry without touching the disk on the game thread.
+ * The game thread pushes records into a lock-free single-producer single-consumer ring buffer (a copy and an atomic store), and a background thread drains the ring into a binary telemetry file.
+ * Records are dropped (and counted) if the writer falls a whole ring behind, so recording never blocks.
+ * Enabled with -HiltTelemetry (or -HiltTelemetry=<file>), convert the files with the MovementTelemetryToCsv commandlet.
+ */
+class HILT_API FMovementTelemetryWriter : public FRunnable
+{
+public:
+
+	//the number of records in the ring (a power of two, about 34 seconds at 120 fps)
+	static constexpr uint32 RingCapacity = 4096;
+
+	//function to create a writer if telemetry is enabled on the command line (nullptr otherwise)
+	static TUniquePtr<FMovementTelemetryWriter> CreateFromCommandLine(const FString& DefaultName);
+
+	//constructor and destructor (the destructor stops the thread after it has written everything recorded)
+	explicit FMovementTelemetryWriter(const FString& InFilePath);
+	virtual ~FMovementTelemetryWriter() override;
+
+	//function to record a frame (game thread only)
+	void Record(const FMovementTelemetryRecord& InRecord);
+
+	//function to get the number of records dropped because the ring was full
+	uint32 GetNumDropped() const { return NumDropped.load(std::memory_order_relaxed); }
+
+	//overrides
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+
+	//the path of the telemetry file
+	FString FilePath;
+
+	//the ring of records
+	TArray<FMovementTelemetryRecord> Ring;
+
+	//the number of records pushed and drained so far (the ring index is the count masked by the capacity)
+	std::atomic<uint32> WriteCount{0};
+	std::atomic<uint32> ReadCount{0};
+
+	//the number of records dropped because the ring was full
+	std::atomic<uint32> NumDropped{0};
+
+	//whether or not the writer thread should finish
+	std::atomic<bool> bStopping{false};
+
+	//the writer thread
+	FRunnableThread* Thread = nullptr;
+
+	//function to write the records in the ring to the file, returns the number written
+	uint32 Drain(FArchive& Archive);
+};
@@ -3,6 +3,7 @@
 // Class includes
 #include "CoreMinimal.h"
 #include "InteractableObjects/BaseInteractableObject.h"
+#include "Core/HiltTimerSubsystem.h"
 #include "LaunchPad.generated.h"
 
 // Forward Declaration`s
@@ -43,7 +44,7 @@ private:
 	// ------------- class Refs ------------
 
 	// ------------- Timer Handlers ------------
-	FTimerHandle MainTimerHandler;
+	FHiltTimerHandle MainTimerHandler;
 
 	// VFX ------------------------------
 	UPROPERTY(EditAnywhere, Category = "VFX")
@@ -65,6 +65,10 @@ public:
 	//constructor
 	UGrappleableComponent();
 
+	//overrides (registers this component with the grapple target subsystem)
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
+
 	//event called when the grappling actor starts grappling to this actor
 	UPROPERTY(BlueprintAssignable)
 	FOnStartGrapple OnStartGrappleEvent;
@@ -5,6 +5,7 @@
 //#include "Components/PlayerMovementComponent.h"
 #include "InputDataAsset.h"
 #include "Core/HiltGameModeBase.h"
+#include "Player/PlayerRewindBuffer.h"
 #include "PlayerCharacter.generated.h"
 
 class AObjectivePoint;
@@ -51,6 +52,10 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 	class UScoreComponent* ScoreComponent;
 
+	//the ground probe component that traces for the ground below the player once per frame
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	class UGroundProbeComponent* GroundProbeComponent;
+
 	//input data asset to use for setting up input
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite)
 	UInputDataAsset* InputDataAsset;
@@ -82,6 +87,27 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	int PlayerSpawnPointIndex = 0;
 
+	//how many steps of player state to keep for rewinding (0 = don't record, 1200 is ten seconds at 120 steps per second), allocated at begin play
+	UPROPERTY(EditDefaultsOnly, Category = "Rewind", meta = (ClampMin = 0))
+	int32 RewindHistoryLength = 1200;
+
+	//how many rope pivots to keep for rewinding (shared by all the recorded steps, steps whose pivots were overwritten can't be rewound to)
+	UPROPERTY(EditDefaultsOnly, Category = "Rewind", meta = (ClampMin = 0))
+	int32 RewindPivotCapacity = 4096;
+
+	//how many steps of player state to record per second (frames faster than this are skipped, so the history length doesn't depend on the frame rate)
+	UPROPERTY(EditDefaultsOnly, Category = "Rewind", meta = (ClampMin = 1))
+	float RewindStepRate = 120;
+
+	//the recorded player state for rewinding (captured at the start of a movement step, once per rewind step)
+	FPlayerRewindBuffer RewindHistory;
+
+	//the gameplay time rewound away so far (subtracted from the gameplay time when capturing, so the recorded times have no gaps)
+	double RewindTimeOffset = 0;
+
+	//the recorded time of the next capture
+	double NextRewindCaptureTime = 0;
+
 	//blueprint event for when the level restarts
 	UPROPERTY(BlueprintAssignable)
 	FOnPlayerRestart OnPlayerRestart;
@@ -103,6 +129,24 @@ public:
 	virtual void SetupPlayerInputComponent(UInputComponent* InInputComponent) override;
 	virtual void BeginPlay() override;
 
+	//function to queue pressed buttons for the fixed-step simulation, returns false if they should be handled right away (see UHiltSimulationSubsystem)
+	bool QueueSimulationButtons(uint8 Buttons) const;
+
+	//function to record the current player state in the rewind history
+	void CaptureRewindFrame();
+
+	//function to restore the player state from the rewind history (0 = the newest step) and drop the steps after it, returns false if it can't be restored
+	UFUNCTION(BlueprintCallable, Category = "Rewind")
+	bool RewindFrames(int32 FramesAgo);
+
+	//function to restore the player state from about the given number of seconds ago (or the oldest recorded step), returns false if it can't be restored
+	UFUNCTION(BlueprintCallable, Category = "Rewind")
+	bool RewindSeconds(float Seconds);
+
+	//function to clear the rewind history (when the level restarts)
+	UFUNCTION(BlueprintCallable, Category = "Rewind")
+	void ResetRewindHistory();
+
 	//function to handle loading streaming levels
 	UFUNCTION(BlueprintCallable)
 	void ShowStreamingLevel(TArray<FName> LevelsToLoad);
@@ -0,0 +1,127 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+//the state flags of a rewind frame
+enum EPlayerRewindFlags : uint8
+{
+	PlayerRewind_Sliding = 1 << 0,
+	PlayerRewind_Diving = 1 << 1,
+	PlayerRewind_SlideJumping = 1 << 2,
+	PlayerRewind_SlideFalling = 1 << 3,
+	PlayerRewind_MightBeBunnyJumping = 1 << 4,
+	PlayerRewind_Grappling = 1 << 5,
+};
+
+//one rope pivot of a rewind frame (a rope point that isn't a simulated verlet point, 24 bytes)
+struct FPlayerRewindPivot
+{
+	//the actor the pivot is attached to (null when the location is relative to the owner)
+	TWeakObjectPtr<AActor> AttachedActor;
+
+	//the location of the pivot relative to the attached actor, or relative to the owner's location
+	FVector3f Location = FVector3f::ZeroVector;
+
+	//the flags of the pivot (FRopeNetPivot::EPivotFlags)
+	uint8 Flags = 0;
+};
+
+//one step of player state, quantised so ten seconds at 120 steps per second fit in about 80 KB (68 bytes)
+struct FPlayerRewindFrame
+{
+	//the recorded time the frame was captured at (the gameplay time minus the time rewound away, so the recorded times stay contiguous across rewinds)
+	float Time = 0;
+
+	//the world location of the player
+	FVector3f Location = FVector3f::ZeroVector;
+
+	//the velocity of the player (in cm/s, clamped to the int16 range)
+	int16 Velocity[3] = {};
+
+	//the rotation of the player and the pitch and yaw of the control rotation (compressed to shorts, see FRotator::CompressAxisToShort)
+	uint16 Rotation[3] = {};
+	uint16 ControlPitch = 0;
+	uint16 ControlYaw = 0;
+
+	//the player's score
+	float Score = 0;
+
+	//the current slide speed (in cm/s) and the time left on the slide jump (in milliseconds)
+	uint16 SlideSpeed = 0;
+	uint16 SlideJumpTimeMs = 0;
+
+	//the slide score that hasn't been banked yet and the slide speed gained it's based on
+	float PendingSlideScore = 0;
+	float SlideSpeedGained = 0;
+
+	//how long ago the slide and the dive started and the dive stopped (the movement component keeps these as gameplay times, which keep running after a rewind)
+	float SlideStartAge = 0;
+	float DiveStartAge = 0;
+	float DiveStopAge = 0;
+
+	//the index of the frame's first rope pivot in the pivot ring (a running count, see FPlayerRewindBuffer::GetPivots)
+	uint32 FirstPivot = 0;
+
+	//the movement mode, custom movement mode and state flags (EPlayerRewindFlags)
+	uint8 MovementMode = 0;
+	uint8 CustomMovementMode = 0;
+	uint8 Flags = 0;
+
+	//the number of rope pivots of the frame
+	uint8 NumPivots = 0;
+};
+static_assert(sizeof(FPlayerRewindFrame) == 68, "keep the rewind frames small, the whole history is kept in memory");
+
+/**
+ * Fixed-size ring buffer of quantised player state for rewinding.
+ * Frames go in one ring and their rope pivots in a second one (most frames have none), both allocated once by SetCapacity, so capturing and restoring never allocate.
+ * A frame's pivots are stored contiguously and can be overwritten before the frame itself when the rope has many pivots for a long time, GetPivots returns nullptr for those frames.
+ */
+class HILT_API FPlayerRewindBuffer
+{
+public:
+
+	//function to set the number of frames and pivots to keep (clears the buffer)
+	void SetCapacity(int32 NumFrames, int32 NumPivots);
+
+	//function to clear the buffer without freeing the rings
+	void Reset();
+
+	//function to get the next frame to write with room for its pivots (overwrites the oldest frame when full), OutPivots is nullptr when NumPivots is 0
+	FPlayerRewindFrame& Push(int32 NumPivots, FPlayerRewindPivot*& OutPivots);
+
+	//function to get a frame by how many pushes ago it was written (0 = newest), returns nullptr if there is none
+	const FPlayerRewindFrame* GetFromNewest(int32 Offset) const;
+
+	//function to get the pivots of a frame, returns nullptr if they've been overwritten (or the frame has none)
+	const FPlayerRewindPivot* GetPivots(const FPlayerRewindFrame& Frame) const;
+
+	//function to drop the newest frames (after rewinding past them)
+	void DiscardNewest(int32 NumFrames);
+
+	//function to get the number of frames in the buffer
+	int32 Num() const { return Count; }
+
+	//function to get the number of frames the buffer can hold
+	int32 GetCapacity() const { return Frames.Num(); }
+
+	//function to get the memory used by the rings
+	SIZE_T GetAllocatedSize() const { return Frames.GetAllocatedSize() + Pivots.GetAllocatedSize(); }
+
+private:
+
+	//the frame and pivot rings
+	TArray<FPlayerRewindFrame> Frames;
+	TArray<FPlayerRewindPivot> Pivots;
+
+	//the index of the next frame to write to
+	int32 Head = 0;
+
+	//the number of valid frames in the buffer
+	int32 Count = 0;
+
+	//the number of pivot slots handed out so far (the pivot index is the count modulo the pivot capacity)
+	uint32 PivotCount = 0;
+};
@@ -91,10 +91,21 @@ class HILT_API UScoreComponent : public UActorComponent
 
 public:
 
+	//event for when the score crosses into a different score tier
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnScoreTierChanged, int32, NewTier, int32, OldTier);
+
 	//the player's score
 	UPROPERTY(BlueprintReadOnly)
 	float Score = 0;
 
+	//the index of the score values the current score falls in
+	UPROPERTY(BlueprintReadOnly)
+	int32 ScoreTier = 0;
+
+	//event called when the score tier changes (so derived values can be cached between tier changes)
+	UPROPERTY(BlueprintAssignable)
+	FOnScoreTierChanged OnScoreTierChanged;
+
 	//the float curve to use for the player's score degradation over time (1 = 100% of the score, 0 = 0% of the score)
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Curves")
 	UCurveFloat* ScoreDegradationCurve = nullptr;
@@ -133,6 +144,9 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void ResetScore();
 
+	//function to set the player's score directly (for rewinding, no gain multiplier or clamping)
+	void RestoreScore(float NewScore);
+
 	//start degredation timer
 	UFUNCTION(BlueprintCallable)
 	void StartDegredationTimer();
@@ -144,5 +158,18 @@ public:
 	//function to get the current score values
 	UFUNCTION(BlueprintCallable)
 	FScoreValues GetCurrentScoreValues() const;
-		
+
+	//function to get a reference to the score values of the current score tier (use this from c++ instead of copying them)
+	const FScoreValues& GetScoreValues() const { return ScoreValues.IsValidIndex(ScoreTier) ? ScoreValues[ScoreTier] : DefaultScoreValues; }
+
+private:
+
+	//the score values used when no score values are set
+	static const FScoreValues DefaultScoreValues;
+
+	//function to set the score and update the score tier
+	void SetScore(float NewScore);
+
+	//function to update the score tier from the score, broadcasting OnScoreTierChanged if it changed
+	void UpdateScoreTier();
 };